@@ -4,11 +4,11 @@ echo "开始编译 alg_main.cpp..."
 
 # 编译参数
 CXX=g++
-CXXFLAGS="-std=c++11 -Wall -Wextra -O2"
+CXXFLAGS="-std=c++11 -Wall -Wextra -O2 -pthread"
 INCLUDES="-I ./src -I ./src/hls_lib"
 
 # 源文件
-SRCS="src/alg_main.cpp src/alg_top.h src/print_function.cpp src/vector_function.h"
+SRCS="src/alg_main.cpp src/alg_top.h src/alg_crop.cpp src/alg_dpc.cpp src/print_function.cpp src/vector_function.h"
 
 # 输出文件
 OUTPUT="alg_main"
@@ -6,7 +6,7 @@ echo "开始编译 gen_image_main.cpp..."
 
 # 设置编译参数
 CXX=g++
-CXXFLAGS="-std=c++11 -Wall -Wextra"
+CXXFLAGS="-std=c++11 -Wall -Wextra -O3 -march=native -pthread"
 
 # 源文件列表
 SRCS="src/gen_image_main.cpp src/print_function.cpp src/vector_function.cpp"
@@ -0,0 +1,25 @@
+#!/bin/bash
+
+echo "开始编译 hls_crop_maxi_main.cpp..."
+
+# 编译参数
+CXX=g++
+CXXFLAGS="-std=c++11 -Wall -Wextra -O2 -DHLS_FAST_STREAM_SIM"
+INCLUDES="-I ./src -I ./src/hls_lib"
+
+# 源文件
+SRCS="src/hls_crop_maxi_main.cpp src/alg_crop.cpp src/print_function.cpp"
+
+# 输出文件
+OUTPUT="hls_crop_maxi_main"
+
+# 编译命令
+$CXX $CXXFLAGS $INCLUDES $SRCS -o $OUTPUT
+
+# 检查编译结果
+if [ $? -eq 0 ]; then
+    echo "编译成功！生成可执行文件: $OUTPUT"
+else
+    echo "编译失败！"
+    exit 1
+fi
\ No newline at end of file
@@ -4,11 +4,24 @@ echo "开始编译 hls_main.cpp..."
 
 # 编译参数
 CXX=g++
-CXXFLAGS="-std=c++11 -Wall -Wextra -O2"
+CXXFLAGS="-std=c++11 -Wall -Wextra -O2 -DHLS_FAST_STREAM_SIM"
+
+# ./compile_hls_main.sh profile: 打开C-sim周期统计 (循环次数/stream读写/stall, cycles/frame)
+# ./compile_hls_main.sh threaded: DATAFLOW的每个process一个线程，stream按深度阻塞，死锁由watchdog报告
+# ./compile_hls_main.sh fastint: 64位以内的ap_uint/ap_int换成原生整数实现 (hls_fast_int.h)
+for arg in "$@"; do
+    if [ "$arg" == "profile" ]; then
+        CXXFLAGS="$CXXFLAGS -DHLS_CSIM_PROFILE"
+    elif [ "$arg" == "threaded" ]; then
+        CXXFLAGS="$CXXFLAGS -DHLS_THREADED_DATAFLOW -pthread"
+    elif [ "$arg" == "fastint" ]; then
+        CXXFLAGS="$CXXFLAGS -DHLS_FAST_INT_SIM"
+    fi
+done
 INCLUDES="-I./src -I./src/hls_lib"
 
 # 源文件
-SRCS="src/hls_main.cpp src/hls_top.cpp src/print_function.cpp src/vector_function.cpp"
+SRCS="src/hls_main.cpp src/hls_top.cpp src/parse_csv_function.cpp src/print_function.cpp src/vector_function.cpp"
 
 # 输出文件
 OUTPUT="hls_main"
@@ -4,11 +4,11 @@ echo "开始编译 output_compare_main.cpp..."
 
 # 编译参数
 CXX=g++
-CXXFLAGS="-std=c++11 -Wall -Wextra -O2"
+CXXFLAGS="-std=c++11 -Wall -Wextra -O3 -pthread"
 INCLUDES="-I./src -I./src/hls_lib"
 
 # 源文件
-SRCS="src/output_compare_main.cpp src/print_function.cpp src/vector_function.cpp"
+SRCS="src/output_compare_main.cpp src/print_function.cpp"
 
 # 输出文件
 OUTPUT="output_compare_main"
@@ -4,7 +4,7 @@ echo "开始编译 parse_csv_function.cpp..."
 
 # 编译参数
 CXX=g++
-CXXFLAGS="-std=c++11 -Wall -Wextra -O2"
+CXXFLAGS="-std=c++11 -Wall -Wextra -O2 -DPARSE_CSV_FUNCTION_MAIN"
 INCLUDES="-I./src -I./src/hls_lib"
 
 # 源文件
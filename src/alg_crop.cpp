@@ -1,2 +1,5 @@
-// #include "alg_crop.h"
+#include "alg_crop.h"
 
+// 显式模板实例化
+template class AlgCrop<uint8_t, uint8_t>;
+template class AlgCrop<uint16_t, uint16_t>;
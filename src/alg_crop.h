@@ -12,6 +12,8 @@
 // tool
 #include "print_function.h"
 #include "parse_json_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
 #include "alg_info.h"
 
 // def
@@ -22,8 +24,8 @@ template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
 class AlgCrop {
 public:
     void run(
-            const std::vector<ALG_INPUT_DATA_TYPE>& input_image,
-            std::vector<ALG_OUTPUT_DATA_TYPE>& output_image,
+            const frame_vector<ALG_INPUT_DATA_TYPE>& input_image,
+            frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image,
             const AlgRegisterSection& alg_register_section
         ) {
             
@@ -75,22 +77,37 @@ public:
             return;
         }
         
-        std::vector<ALG_OUTPUT_DATA_TYPE> cropped_image(crop_width * crop_height);
+        frame_vector<ALG_OUTPUT_DATA_TYPE> cropped_image(crop_width * crop_height);
         
+        // 按行整段拷贝，8/16bit都可以向量化
         for (int y = alg_register_section.reg_crop_start_y; y <= alg_register_section.reg_crop_end_y; ++y) {
-            for (int x = alg_register_section.reg_crop_start_x; x <= alg_register_section.reg_crop_end_x; ++x) {
-                int src_idx = y * alg_register_section.reg_image_width + x;
-                int dst_idx = (y - alg_register_section.reg_crop_start_y) * crop_width + (x - alg_register_section.reg_crop_start_x);
-                if (src_idx < input_image.size()) {
-                    cropped_image[dst_idx] = input_image[src_idx];
-                }
-            }
+            int src_idx = y * alg_register_section.reg_image_width + alg_register_section.reg_crop_start_x;
+            int dst_idx = (y - alg_register_section.reg_crop_start_y) * crop_width;
+            std::copy(input_image.begin() + src_idx, input_image.begin() + src_idx + crop_width, cropped_image.begin() + dst_idx);
         }
         
-        output_image = cropped_image;
+        output_image.swap(cropped_image);
 
     }
 
+    // registers read by this stage, combined into the AlgTop stage cache key
+    static uint64_t register_hash(const AlgRegisterSection& alg_register_section, uint64_t input_key) {
+        uint64_t key = input_key;
+        key = hash64_combine(key, alg_register_section.reg_image_width);
+        key = hash64_combine(key, alg_register_section.reg_image_height);
+        key = hash64_combine(key, alg_register_section.reg_crop_enable);
+        if (alg_register_section.reg_crop_enable) {
+            key = hash64_combine(key, alg_register_section.reg_crop_start_x);
+            key = hash64_combine(key, alg_register_section.reg_crop_start_y);
+            key = hash64_combine(key, alg_register_section.reg_crop_end_x);
+            key = hash64_combine(key, alg_register_section.reg_crop_end_y);
+        }
+        return key;
+    }
+
 };
 
+extern template class AlgCrop<uint8_t, uint8_t>;
+extern template class AlgCrop<uint16_t, uint16_t>;
+
 #endif // ALG_CROP_H
\ No newline at end of file
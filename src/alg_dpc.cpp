@@ -3,9 +3,11 @@
 #include <algorithm>
 #include <iostream>
 #include <vector>
+#include <limits>
 
 // 辅助函数：获取带镜像边界的像素值
-alg_pixel_t get_mirrored_pixel(const std::vector<alg_pixel_t>& img, int width, int height, int x, int y) {
+template <typename T>
+static inline T get_mirrored_pixel(const frame_vector<T>& img, int width, int height, int x, int y) {
     // 镜像边界处理
     x = std::max(0, std::min(width - 1, x));
     y = std::max(0, std::min(height - 1, y));
@@ -13,14 +15,18 @@ alg_pixel_t get_mirrored_pixel(const std::vector<alg_pixel_t>& img, int width, i
 }
 
 template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
-std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::process_image(
-    const std::vector<alg_pixel_t>& input_image,
+void AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::process_image(
+    const frame_vector<ALG_INPUT_DATA_TYPE>& input_image,
+    frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image,
     int width, int height,
     bool enable,
     int threshold) {
         
+    // 初始化输出数据为输入数据的副本
+    output_image.assign(input_image.begin(), input_image.end());
+
     if (!enable) {
-        return input_image;
+        return;
     }
     
     // 验证输入数据量与预期是否匹配
@@ -28,12 +34,10 @@ std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::proc
     if (input_image.size() != expected_input_size) {
         std::cerr << "Error: Input data size mismatch. Expected: " << expected_input_size 
                   << " pixels, Actual: " << input_image.size() << " pixels" << std::endl;
-        return {};
+        output_image.clear();
+        return;
     }
     
-    // 初始化输出数据为输入数据的副本
-    std::vector<alg_pixel_t> output_image = input_image;
-    
     // 遍历整幅图像
     for (int y = 0; y < height; ++y) {
         for (int x = 0; x < width; ++x) {
@@ -42,8 +46,8 @@ std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::proc
             // --- 坏点检测 ---
             // 条件1: 中心像素值是否在其邻域的最大/最小值范围之外
             // 使用5x5窗口但只考虑特定位置的像素（与Python版本的window对应）
-            alg_pixel_t min_neighbor = 65535; // 假设alg_pixel_t是16位
-            alg_pixel_t max_neighbor = 0;
+            ALG_INPUT_DATA_TYPE min_neighbor = std::numeric_limits<ALG_INPUT_DATA_TYPE>::max();
+            ALG_INPUT_DATA_TYPE max_neighbor = 0;
 
             // 5x5窗口中的特定位置（对应Python版本的window）
             int window_positions[8][2] = {
@@ -55,28 +59,11 @@ std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::proc
             for (int i = 0; i < 8; ++i) {
                 int nx = x + window_positions[i][0];
                 int ny = y + window_positions[i][1];
-                alg_pixel_t neighbor = get_mirrored_pixel(input_image, width, height, nx, ny);
+                ALG_INPUT_DATA_TYPE neighbor = get_mirrored_pixel(input_image, width, height, nx, ny);
                 min_neighbor = std::min(min_neighbor, neighbor);
                 max_neighbor = std::max(max_neighbor, neighbor);
             }
 
-            #if 1
-                int32_t p00 = get_mirrored_pixel(input_image, width, height, x-2, y-2);
-                int32_t p01 = get_mirrored_pixel(input_image, width, height, x, y-2);
-                int32_t p02 = get_mirrored_pixel(input_image, width, height, x+2, y-2);
-                int32_t p10 = get_mirrored_pixel(input_image, width, height, x-2, y);
-                int32_t p11 = get_mirrored_pixel(input_image, width, height, x, y);
-                int32_t p12 = get_mirrored_pixel(input_image, width, height, x+2, y);
-                int32_t p20 = get_mirrored_pixel(input_image, width, height, x-2, y+2);
-                int32_t p21 = get_mirrored_pixel(input_image, width, height, x, y+2);
-                int32_t p22 = get_mirrored_pixel(input_image, width, height, x+2, y+2);
-                printf("pixel win remap debug\n");
-                printf("coord = (%4x, %4x)\n", x, y);
-                printf("%4x, %4x, %4x\n", p00, p01, p02);
-                printf("%4x, %4x, %4x\n", p10, p11, p12);
-                printf("%4x, %4x, %4x\n", p20, p21, p22);
-            #endif
-
             bool cond1_met = (p0 < min_neighbor) || (p0 > max_neighbor);
 
             // 条件2: 中心像素与所有8个邻居的差的绝对值是否都大于阈值
@@ -92,7 +79,7 @@ std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::proc
                 for (int i = 0; i < 8; ++i) {
                     int nx = x + neighbor_positions[i][0];
                     int ny = y + neighbor_positions[i][1];
-                    alg_pixel_t neighbor = get_mirrored_pixel(input_image, width, height, nx, ny);
+                    ALG_INPUT_DATA_TYPE neighbor = get_mirrored_pixel(input_image, width, height, nx, ny);
                     if (std::abs(p0 - static_cast<int32_t>(neighbor)) <= threshold) {
                         cond2_met = false;
                         break;
@@ -150,15 +137,14 @@ std::vector<alg_pixel_t> AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::proc
                 }
 
                 // 使用校正后的值更新输出数据
-                output_image[y * width + x] = static_cast<alg_pixel_t>(new_p0);
+                output_image[y * width + x] = static_cast<ALG_OUTPUT_DATA_TYPE>(new_p0);
             }
         }
     }
-
-    return output_image;
 }
 
 // 显式模板实例化
-template class AlgDpc<unsigned short, unsigned short>;
+template class AlgDpc<uint8_t, uint8_t>;
+template class AlgDpc<uint16_t, uint16_t>;
 
 
@@ -8,20 +8,19 @@
 // tool
 #include "print_function.h"
 #include "parse_json_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
 #include "alg_info.h"
 
 // def
 #define ALG_DPC_SECTION "[AlgDpc]"
 
-// 算法模型使用的数据类型
-using alg_pixel_t = uint16_t;
-
 template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
 class AlgDpc {
 public:
     void run(
-            const std::vector<ALG_INPUT_DATA_TYPE>& input_image,
-            std::vector<ALG_OUTPUT_DATA_TYPE>& output_image,
+            const frame_vector<ALG_INPUT_DATA_TYPE>& input_image,
+            frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image,
             const AlgRegisterSection& alg_register_section
         ) {
             
@@ -38,28 +37,37 @@ public:
 
             assert(input_image.size() == expected_input_size);
             
-            // 转换输入图像到alg_pixel_t类型
-            std::vector<alg_pixel_t> input_converted(input_image.begin(), input_image.end());
-            
-            // 调用处理函数
-            std::vector<alg_pixel_t> result = process_image(
-                input_converted,
+            // 直接在输入位宽上处理，8bit数据不再转换为16bit
+            process_image(
+                input_image,
+                output_image,
                 alg_register_section.reg_image_width,
                 alg_register_section.reg_image_height,
                 alg_register_section.reg_dpc_enable,
                 alg_register_section.reg_dpc_threshold
             );
-            
-            // 转换结果到输出类型
-            output_image.assign(result.begin(), result.end());
         }
     
-    static std::vector<alg_pixel_t> process_image(
-        const std::vector<alg_pixel_t>& input_image,
+    // registers read by this stage, combined into the AlgTop stage cache key
+    static uint64_t register_hash(const AlgRegisterSection& alg_register_section, uint64_t input_key) {
+        uint64_t key = input_key;
+        key = hash64_combine(key, alg_register_section.reg_image_width);
+        key = hash64_combine(key, alg_register_section.reg_image_height);
+        key = hash64_combine(key, alg_register_section.reg_dpc_enable);
+        key = hash64_combine(key, alg_register_section.reg_dpc_enable ? alg_register_section.reg_dpc_threshold : 0);
+        return key;
+    }
+
+    static void process_image(
+        const frame_vector<ALG_INPUT_DATA_TYPE>& input_image,
+        frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image,
         int width, int height,
         bool enable,
         int threshold
     );
 };
 
+extern template class AlgDpc<uint8_t, uint8_t>;
+extern template class AlgDpc<uint16_t, uint16_t>;
+
 #endif // ALG_DPC_H
@@ -10,6 +10,7 @@
 #include "print_function.h"
 #include "vector_function.h"
 #include "parse_json_function.h"
+#include "frame_buffer_pool.h"
 
 // ip
 #include "alg_top.h"
@@ -20,10 +21,89 @@ using namespace std;
 
 // def
 // #define ALG_MAIN_SECTION "[AlgMain]"
-#define ALG_INPUT_DATA_TYPE uint16_t
-#define ALG_OUTPUT_DATA_TYPE uint16_t
 
 
+template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
+int run_alg_top(const int argc, const char *argv[], RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
+    // option
+    bool interactive_enable = false;
+    bool dpc_stage_enable = false;
+    string frame_list_path;
+    int prefetch_queue_depth = IMAGE_PREFETCHER_QUEUE_DEPTH;
+    size_t prefetch_memory_budget = IMAGE_PREFETCHER_MEMORY_BUDGET;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--interactive") {
+            interactive_enable = true;
+        } else if (arg == "--dpc") {
+            dpc_stage_enable = true;
+        } else if (arg == "--frames" && i + 1 < argc) {
+            frame_list_path = argv[++i];
+        } else if (arg == "--prefetch-depth" && i + 1 < argc) {
+            prefetch_queue_depth = atoi(argv[++i]);
+        } else if (arg == "--prefetch-budget-mb" && i + 1 < argc) {
+            prefetch_memory_budget = size_t(atoi(argv[++i])) << 20;
+        }
+    }
+
+    AlgTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_top;
+    alg_top.alg_dpc_stage_enable = dpc_stage_enable;
+
+    // multi-frame run: one input path per line of the frame list
+    if (!frame_list_path.empty()) {
+        ifstream frame_list_file(frame_list_path);
+        if (!frame_list_file.is_open()) {
+            MAIN_ERROR_1("Cannot open frame list: " + frame_list_path);
+        }
+        vector<string> frame_path_list;
+        string line;
+        while (getline(frame_list_file, line)) {
+            line.erase(0, line.find_first_not_of(" \t"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (!line.empty() && line[0] != '#') {
+                frame_path_list.push_back(line);
+            }
+        }
+        MAIN_INFO_1("alg_top multi-frame run...");
+        alg_top.runFrameList(register_section, image_section, output_section, frame_path_list, prefetch_queue_depth, prefetch_memory_budget);
+        return 0;
+    }
+
+    // alg_top run
+    MAIN_INFO_1("alg_top run...");
+    alg_top.run(register_section, image_section, output_section);
+
+    // interactive tuning session: "<reg_name> <value>" per line, "quit" to exit
+    if (interactive_enable) {
+        MAIN_INFO_1("interactive mode, input: <reg_name> <value> | quit");
+        string line;
+        while (getline(cin, line)) {
+            istringstream iss(line);
+            string reg_name;
+            int reg_value;
+            if (!(iss >> reg_name) || reg_name == "quit") {
+                break;
+            }
+            if (!(iss >> reg_value)) {
+                MAIN_INFO_1("missing value for: " + reg_name);
+                continue;
+            }
+            if (register_section.reg_map.find(reg_name) == register_section.reg_map.end()) {
+                MAIN_INFO_1("unknown register: " + reg_name);
+                continue;
+            }
+            register_section.reg_map[reg_name].reg_initial_value[0] = reg_value;
+            MAIN_INFO_1(reg_name + " = " + to_string(reg_value));
+            alg_top.update(register_section);
+        }
+    }
+    
+    return 0;
+}
+
+
+// usage: alg_main [--dpc] [--interactive] [--frames frame_list.txt] [--prefetch-depth N] [--prefetch-budget-mb N]
+// --dpc runs dpc ahead of crop like hls_main, without it the output is the crop of the input
 int main(const int argc, const char *argv[]) {
     // json config loading
     string config_path = "/home/sheldon/hls_project/vibe_crop/src/vibe.json";
@@ -44,7 +124,7 @@ int main(const int argc, const char *argv[]) {
     MAIN_INFO_1("object: register_section parse follow...");
     RegisterSection register_section = data["register_info"].get<RegisterSection>();
     MAIN_INFO_1("object: output_section parse follow...");
-    OutputSection output_section = data["output_info"].get<OutputSection>();
+    OutputSection output_section = GetOutputSection(data);
 
     // object print
     MAIN_INFO_1("object: image_section print follow...");
@@ -58,26 +138,18 @@ int main(const int argc, const char *argv[]) {
     int height = register_section.reg_map["reg_image_height"].reg_initial_value[0];
     MAIN_INFO_1("image width: " + to_string(width));
     MAIN_INFO_1("image height: " + to_string(height));
-    
-    // src image load
-    string source_image_path;
-    vector<ALG_INPUT_DATA_TYPE> input_image;
-    vector<ALG_OUTPUT_DATA_TYPE> output_image;
-    if (image_section.generate_random_image) {
-        source_image_path = image_section.random_image_path;
+
+    // kernel instantiation picked from the configured bit depth
+    int bitwidth = image_section.src_image_data_bitwidth;
+    MAIN_INFO_1("image data bitwidth: " + to_string(bitwidth));
+    int ret = -1;
+    if (bitwidth > 0 && bitwidth <= 8) {
+        ret = run_alg_top<uint8_t, uint8_t>(argc, argv, register_section, image_section, output_section);
+    } else if (bitwidth > 8 && bitwidth <= 16) {
+        ret = run_alg_top<uint16_t, uint16_t>(argc, argv, register_section, image_section, output_section);
     } else {
-        source_image_path = image_section.image_path;
-    }
-    MAIN_INFO_1("loading image: " + source_image_path);
-    input_image = vector_read_from_file<ALG_INPUT_DATA_TYPE>(source_image_path);
-    if (input_image.empty()) {
-        MAIN_ERROR_1("Cannot load image: " + source_image_path);
+        MAIN_ERROR_1("Unsupported image data bitwidth: " + to_string(bitwidth));
     }
-
-    // alg_top run
-    MAIN_INFO_1("alg_top run...");
-    AlgTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_top;
-    alg_top.run(register_section, image_section, output_section);
-    
-    return 0;
+    FrameBufferPool::instance().print_stats();
+    return ret;
 }
\ No newline at end of file
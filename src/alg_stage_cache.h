@@ -0,0 +1,89 @@
+#ifndef ALG_STAGE_CACHE_H
+#define ALG_STAGE_CACHE_H
+
+// std
+#include <list>
+#include <iterator>
+#include <utility>
+#include <cstdint>
+
+// tool
+#include "frame_buffer_pool.h"
+
+// def
+#define ALG_STAGE_CACHE_DEPTH 4
+
+// using
+using namespace std;
+
+
+// per-stage output cache keyed by hash(stage input key, registers read by the stage)
+// keeps the most recently used ALG_STAGE_CACHE_DEPTH outputs besides the current one
+// the current output stays in the caller's buffer, select() only swaps buffers with the cache,
+// a frame is never copied in or out
+template <typename T>
+class AlgStageCache {
+public:
+    AlgStageCache() : cache_hit(0), cache_miss(0), current_valid(false), current_key(0) {};
+    ~AlgStageCache() {};
+
+    size_t cache_hit;
+    size_t cache_miss;
+
+    // makes output_image the stage output for key
+    //  - true: key was the current output or cached, output_image holds it
+    //  - false: the previous output is cached, output_image is a recycled buffer the stage overwrites
+    bool select(uint64_t key, frame_vector<T>& output_image) {
+        if (current_valid && current_key == key) {
+            cache_hit++;
+            return true;
+        }
+        for (typename list<pair<uint64_t, frame_vector<T>>>::iterator it = cache_list.begin(); it != cache_list.end(); ++it) {
+            if (it->first == key) {
+                it->second.swap(output_image);
+                if (current_valid) {
+                    it->first = current_key;
+                    cache_list.splice(cache_list.begin(), cache_list, it);
+                } else {
+                    cache_list.erase(it);
+                }
+                current_key = key;
+                current_valid = true;
+                cache_hit++;
+                return true;
+            }
+        }
+        if (current_valid) {
+            if (cache_list.size() >= ALG_STAGE_CACHE_DEPTH) {
+                // the oldest entry's buffer comes back as the new output buffer
+                cache_list.splice(cache_list.begin(), cache_list, prev(cache_list.end()));
+            } else {
+                cache_list.push_front(pair<uint64_t, frame_vector<T>>());
+            }
+            cache_list.front().first = current_key;
+            cache_list.front().second.swap(output_image);
+        }
+        current_key = key;
+        current_valid = true;
+        cache_miss++;
+        return false;
+    }
+
+    // the caller's buffer no longer holds a cached output (stage skipped, cache disabled, ...)
+    void invalidate() {
+        current_valid = false;
+    }
+
+    void clear() {
+        cache_list.clear();
+        current_valid = false;
+    }
+
+private:
+    list<pair<uint64_t, frame_vector<T>>> cache_list;
+    bool current_valid;
+    uint64_t current_key;
+};
+
+
+#endif // ALG_STAGE_CACHE_H
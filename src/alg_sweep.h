@@ -0,0 +1,285 @@
+#ifndef ALG_SWEEP_H
+#define ALG_SWEEP_H
+
+// std
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <iomanip>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// tool
+#include "json.hpp"
+#include "print_function.h"
+#include "vector_function.h"
+#include "parse_json_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "alg_info.h"
+#include "alg_top.h"
+
+// using
+using json = nlohmann::json;
+using namespace std;
+
+// def
+#define ALG_SWEEP_SECTION "AlgSweep"
+
+
+struct AlgSweepResult {
+    bool valid;
+    int output_width;
+    int output_height;
+    uint64_t output_hash;
+    int output_min;
+    int output_max;
+    double output_mean;
+    size_t dpc_corrected_count;     // pixels changed by dpc
+};
+
+
+// runs AlgTop::process once per register combination on one shared, read-only input
+template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
+class AlgSweep {
+public:
+    AlgSweep() {};
+    ~AlgSweep() {};
+
+    // swept register keys and one value list per sweep point
+    vector<string> sweep_reg_name;
+    vector<vector<int>> sweep_point_list;
+    vector<AlgSweepResult> sweep_result_list;
+    bool sweep_dpc_stage_enable = false;    // AlgTop::alg_dpc_stage_enable of every sweep point
+
+
+    // sweep_info.mode = "grid": cartesian product of sweep_info.register
+    //     "reg_x": [v0, v1, ...] or "reg_x": {"start": a, "end": b, "step": s}
+    // sweep_info.mode = "list": sweep_info.register_list = [{"reg_x": v, "reg_y": w}, ...]
+    // sweep_info.dpc_stage_enable = 1: run dpc ahead of crop (dpc registers have no effect otherwise)
+    void loadSweepSection(const json& sweep_info, RegisterSection& register_section) {
+        MAIN_INFO_1("Sweep Section loading...");
+        sweep_reg_name.clear();
+        sweep_point_list.clear();
+        sweep_dpc_stage_enable = sweep_info.value("dpc_stage_enable", 0) != 0;
+
+        string mode = sweep_info.value("mode", string("grid"));
+        if (mode == "grid") {
+            vector<vector<int>> reg_value_list;
+            for (auto& reg : sweep_info["register"].items()) {
+                sweep_reg_name.push_back(reg.key());
+                reg_value_list.push_back(parseValueList(reg.value()));
+            }
+            checkRegisterName(register_section);
+
+            // cartesian product, last register varies fastest
+            size_t point_num = reg_value_list.empty() ? 0 : 1;
+            for (size_t i = 0; i < reg_value_list.size(); i++) {
+                point_num *= reg_value_list[i].size();
+            }
+            sweep_point_list.resize(point_num);
+            for (size_t p = 0; p < point_num; p++) {
+                size_t index = p;
+                sweep_point_list[p].resize(reg_value_list.size());
+                for (int i = (int)reg_value_list.size() - 1; i >= 0; i--) {
+                    sweep_point_list[p][i] = reg_value_list[i][index % reg_value_list[i].size()];
+                    index /= reg_value_list[i].size();
+                }
+            }
+        } else if (mode == "list") {
+            const json& register_list = sweep_info["register_list"];
+            for (auto& point : register_list) {
+                for (auto& reg : point.items()) {
+                    if (find(sweep_reg_name.begin(), sweep_reg_name.end(), reg.key()) == sweep_reg_name.end()) {
+                        sweep_reg_name.push_back(reg.key());
+                    }
+                }
+            }
+            checkRegisterName(register_section);
+
+            // registers missing from a list entry keep their configured value
+            for (auto& point : register_list) {
+                vector<int> reg_value(sweep_reg_name.size());
+                for (size_t i = 0; i < sweep_reg_name.size(); i++) {
+                    if (point.contains(sweep_reg_name[i])) {
+                        reg_value[i] = point[sweep_reg_name[i]].get<int>();
+                    } else {
+                        reg_value[i] = register_section.reg_map[sweep_reg_name[i]].reg_initial_value[0];
+                    }
+                }
+                sweep_point_list.push_back(reg_value);
+            }
+        } else {
+            MAIN_ERROR_1("Unknown sweep mode: " + mode);
+        }
+        MAIN_INFO_1("sweep register num: " + to_string(sweep_reg_name.size()) + ", sweep point num: " + to_string(sweep_point_list.size()));
+    }
+
+
+    void run(RegisterSection& register_section, const frame_vector<ALG_INPUT_DATA_TYPE>& input_image, int thread_num) {
+        if (thread_num <= 0) {
+            thread_num = max(1, (int)thread::hardware_concurrency());
+        }
+        thread_num = min(thread_num, max(1, (int)sweep_point_list.size()));
+        MAIN_INFO_1("sweep run, thread num: " + to_string(thread_num));
+
+        // resolve every sweep point to a register section up front,
+        // the worker threads then only touch their own AlgTop and result slot
+        vector<AlgRegisterSection> alg_register_list(sweep_point_list.size());
+        for (size_t p = 0; p < sweep_point_list.size(); p++) {
+            RegisterSection point_register_section = register_section;
+            for (size_t i = 0; i < sweep_reg_name.size(); i++) {
+                point_register_section.reg_map[sweep_reg_name[i]].reg_initial_value[0] = sweep_point_list[p][i];
+            }
+            AlgTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::parseRegisterSection(point_register_section, alg_register_list[p]);
+        }
+
+        uint64_t input_hash = vector_hash64(input_image);
+        sweep_result_list.assign(sweep_point_list.size(), AlgSweepResult());
+        atomic<size_t> next_point(0);
+        vector<thread> worker_list;
+        for (int t = 0; t < thread_num; t++) {
+            worker_list.push_back(thread([&]() {
+                AlgTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_top;
+                alg_top.alg_dpc_stage_enable = sweep_dpc_stage_enable;
+                for (size_t p = next_point++; p < sweep_point_list.size(); p = next_point++) {
+                    alg_top.alg_register_section = alg_register_list[p];
+                    runPoint(alg_top, input_image, input_hash, sweep_result_list[p]);
+                }
+            }));
+        }
+        for (size_t t = 0; t < worker_list.size(); t++) {
+            worker_list[t].join();
+        }
+        MAIN_INFO_1("sweep run completed");
+    }
+
+
+    void printResult(ostream& os) const {
+        os << setw(6) << "index";
+        for (size_t i = 0; i < sweep_reg_name.size(); i++) {
+            os << " " << setw(max<size_t>(8, sweep_reg_name[i].size())) << sweep_reg_name[i];
+        }
+        os << " " << setw(6) << "valid" << " " << setw(6) << "width" << " " << setw(6) << "height"
+           << " " << setw(16) << "hash" << " " << setw(6) << "min" << " " << setw(6) << "max"
+           << " " << setw(10) << "mean" << " " << setw(10) << "dpc_fix" << "\n";
+        for (size_t p = 0; p < sweep_point_list.size(); p++) {
+            const AlgSweepResult& result = sweep_result_list[p];
+            os << setw(6) << p;
+            for (size_t i = 0; i < sweep_reg_name.size(); i++) {
+                os << " " << setw(max<size_t>(8, sweep_reg_name[i].size())) << sweep_point_list[p][i];
+            }
+            os << " " << setw(6) << result.valid;
+            if (result.valid) {
+                os << " " << setw(6) << result.output_width << " " << setw(6) << result.output_height
+                   << " " << hex << setw(16) << setfill('0') << result.output_hash << dec << setfill(' ')
+                   << " " << setw(6) << result.output_min << " " << setw(6) << result.output_max
+                   << " " << setw(10) << fixed << setprecision(3) << result.output_mean
+                   << " " << setw(10) << result.dpc_corrected_count;
+            }
+            os << "\n";
+        }
+    }
+
+    bool writeResult(const string& filename) const {
+        ofstream output_file(filename);
+        if (!output_file) {
+            std::cerr << "Cannot open output file: " << filename << std::endl;
+            return false;
+        }
+        printResult(output_file);
+        output_file.close();
+        return true;
+    }
+
+
+private:
+    static vector<int> parseValueList(const json& j) {
+        vector<int> value_list;
+        if (j.is_array()) {
+            value_list = j.get<vector<int>>();
+        } else if (j.is_object()) {
+            int start = j["start"].get<int>();
+            int end = j["end"].get<int>();
+            int step = j.value("step", 1);
+            if (step <= 0) {
+                MAIN_ERROR_1("Sweep step must be positive");
+            }
+            for (int v = start; v <= end; v += step) {
+                value_list.push_back(v);
+            }
+        } else {
+            value_list.push_back(j.get<int>());
+        }
+        return value_list;
+    }
+
+    void checkRegisterName(RegisterSection& register_section) const {
+        for (size_t i = 0; i < sweep_reg_name.size(); i++) {
+            if (register_section.reg_map.find(sweep_reg_name[i]) == register_section.reg_map.end()) {
+                MAIN_ERROR_1("Sweep register not found in register_info: " + sweep_reg_name[i]);
+            }
+        }
+    }
+
+    // configurations the kernels would reject (and exit on) are reported as invalid instead
+    static bool checkRegisterSection(const AlgRegisterSection& regs, size_t input_size) {
+        if (regs.reg_image_width <= 0 || regs.reg_image_height <= 0) {
+            return false;
+        }
+        if ((size_t)regs.reg_image_width * regs.reg_image_height != input_size) {
+            return false;
+        }
+        if (regs.reg_crop_enable) {
+            if (regs.reg_crop_start_x < 0 || regs.reg_crop_start_y < 0) {
+                return false;
+            }
+            if (regs.reg_crop_start_x > regs.reg_crop_end_x || regs.reg_crop_start_y > regs.reg_crop_end_y) {
+                return false;
+            }
+            if (regs.reg_crop_end_x >= regs.reg_image_width || regs.reg_crop_end_y >= regs.reg_image_height) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void runPoint(
+        AlgTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>& alg_top,
+        const frame_vector<ALG_INPUT_DATA_TYPE>& input_image,
+        uint64_t input_hash,
+        AlgSweepResult& result
+    ) {
+        result.valid = checkRegisterSection(alg_top.alg_register_section, input_image.size());
+        if (!result.valid) {
+            return;
+        }
+        alg_top.process(input_image, input_hash);
+
+        const frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image = alg_top.alg_crop_output_image;
+        result.output_width = alg_top.getOutputWidth();
+        result.output_height = alg_top.getOutputHeight();
+        result.output_hash = vector_hash64(output_image);
+        result.output_min = output_image.empty() ? 0 : (int)*min_element(output_image.begin(), output_image.end());
+        result.output_max = output_image.empty() ? 0 : (int)*max_element(output_image.begin(), output_image.end());
+        double sum = 0;
+        for (size_t i = 0; i < output_image.size(); i++) {
+            sum += output_image[i];
+        }
+        result.output_mean = output_image.empty() ? 0 : sum / output_image.size();
+
+        result.dpc_corrected_count = 0;
+        const frame_vector<ALG_OUTPUT_DATA_TYPE>& dpc_output_image = alg_top.alg_dpc_output_image;
+        for (size_t i = 0; i < dpc_output_image.size() && i < input_image.size(); i++) {
+            result.dpc_corrected_count += (dpc_output_image[i] != input_image[i]);
+        }
+    }
+};
+
+
+#endif // ALG_SWEEP_H
@@ -0,0 +1,107 @@
+// std
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+// tool
+#include "json.hpp"
+#include "print_function.h"
+#include "vector_function.h"
+#include "parse_json_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "alg_sweep.h"
+
+// using
+using json = nlohmann::json;
+using namespace std;
+
+
+template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE>
+int run_alg_sweep(const json& sweep_info, RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
+    // src image load, once for the whole sweep
+    string source_image_path;
+    if (image_section.generate_random_src_image_enable) {
+        source_image_path = output_section.random_src_image_path;
+    } else {
+        source_image_path = output_section.src_image_path;
+    }
+    MAIN_INFO_1("loading image: " + source_image_path);
+    frame_vector<ALG_INPUT_DATA_TYPE> input_image;
+    vector_read_from_file(source_image_path, input_image);
+    if (input_image.empty()) {
+        MAIN_ERROR_1("Cannot load image: " + source_image_path);
+    }
+
+    // alg_sweep run
+    MAIN_INFO_1("alg_sweep run...");
+    AlgSweep<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_sweep;
+    alg_sweep.loadSweepSection(sweep_info, register_section);
+    alg_sweep.run(register_section, input_image, sweep_info.value("thread_num", 0));
+
+    alg_sweep.printResult(cout);
+    string output_path = sweep_info.value("output_path", string("data/alg_sweep_result.txt"));
+    if (alg_sweep.writeResult(output_path)) {
+        MAIN_INFO_1("sweep result save to: " + output_path);
+    }
+
+    return 0;
+}
+
+
+int main(const int argc, const char *argv[]) {
+    // json config loading
+    string config_path = "/home/sheldon/hls_project/vibe_crop/src/vibe.json";
+    string sweep_config_path = "/home/sheldon/hls_project/vibe_crop/src/alg_sweep_config.json";
+    if (argc > 1) {
+        sweep_config_path = argv[1];
+    }
+    if (argc > 2) {
+        config_path = argv[2];
+    }
+
+    ifstream f(config_path);
+    if (!f.is_open()) {
+        MAIN_ERROR_1("Cannot open vibe.json configuration file");
+    }
+    MAIN_INFO_1("vibe.json configuration file path: " + config_path);
+    json data = json::parse(f);
+    f.close();
+
+    ifstream sf(sweep_config_path);
+    if (!sf.is_open()) {
+        MAIN_ERROR_1("Cannot open sweep configuration file: " + sweep_config_path);
+    }
+    MAIN_INFO_1("sweep configuration file path: " + sweep_config_path);
+    json sweep_data = json::parse(sf);
+    sf.close();
+    json sweep_info = sweep_data["sweep_info"];
+
+    // object loading
+    MAIN_INFO_1("object: image_section parse follow...");
+    ImageSection image_section = data["image_info"].get<ImageSection>();
+    MAIN_INFO_1("object: register_section parse follow...");
+    RegisterSection register_section = data["register_info"].get<RegisterSection>();
+    MAIN_INFO_1("object: output_section parse follow...");
+    OutputSection output_section = GetOutputSection(data);
+    image_section.print_values();
+    register_section.print_values();
+    output_section.print_values();
+
+    // kernel instantiation picked from the configured bit depth
+    int bitwidth = image_section.src_image_data_bitwidth;
+    MAIN_INFO_1("image data bitwidth: " + to_string(bitwidth));
+    int ret = -1;
+    if (bitwidth > 0 && bitwidth <= 8) {
+        ret = run_alg_sweep<uint8_t, uint8_t>(sweep_info, register_section, image_section, output_section);
+    } else if (bitwidth > 8 && bitwidth <= 16) {
+        ret = run_alg_sweep<uint16_t, uint16_t>(sweep_info, register_section, image_section, output_section);
+    } else {
+        MAIN_ERROR_1("Unsupported image data bitwidth: " + to_string(bitwidth));
+    }
+    FrameBufferPool::instance().print_stats();
+    return ret;
+}
\ No newline at end of file
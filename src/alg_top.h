@@ -7,16 +7,21 @@
 #include <vector>
 #include <random>
 #include <string>
+#include <iomanip>
 
 // tool
 #include "parse_json_function.h"
 #include "print_function.h"
 #include "vector_function.h"
+#include "hash_manifest_function.h"
+#include "frame_buffer_pool.h"
+#include "alg_stage_cache.h"
+#include "image_prefetcher.h"
 
 // ip
 #include "alg_info.h"
 #include "alg_crop.h"
-// #include "alg_dpc.h"
+#include "alg_dpc.h"
 
 // using
 using json = nlohmann::json;
@@ -38,17 +43,35 @@ public:
     AlgOutputSection alg_output_section;
 
     // data object
-    vector<ALG_INPUT_DATA_TYPE> alg_input_image;
-    vector<ALG_OUTPUT_DATA_TYPE> alg_output_image;
+    frame_vector<ALG_INPUT_DATA_TYPE> alg_input_image;
+    uint64_t alg_input_hash = 0;
+    frame_vector<ALG_OUTPUT_DATA_TYPE> alg_dpc_output_image;
+    frame_vector<ALG_OUTPUT_DATA_TYPE> alg_crop_output_image;
 
     // ip object
-    AlgCrop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_crop;
-    // AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_dpc;
+    AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_dpc;
+    AlgCrop<ALG_OUTPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE> alg_crop;
+
+    // stage object
+    // dpc ahead of crop, the order of the hls DATAFLOW pipeline (hls_pipeline.h), needed to compare
+    // against HlsTop; off keeps the crop-only reference output of the existing configs
+    bool alg_dpc_stage_enable = false;
+
+    // stage cache object
+    bool alg_stage_cache_enable = true;
+    bool alg_dpc_rerun = false;
+    bool alg_crop_rerun = false;
+    AlgStageCache<ALG_OUTPUT_DATA_TYPE> alg_dpc_cache;
+    AlgStageCache<ALG_OUTPUT_DATA_TYPE> alg_crop_cache;
 
 
     void loadRegisterSection(RegisterSection& register_section) {
         // register info
         MAIN_INFO_1("Register Section loading...");
+        parseRegisterSection(register_section, alg_register_section);
+    }
+
+    static void parseRegisterSection(RegisterSection& register_section, AlgRegisterSection& alg_register_section) {
         alg_register_section.reg_image_width = register_section.reg_map["reg_image_width"].reg_initial_value[0];
         alg_register_section.reg_image_height = register_section.reg_map["reg_image_height"].reg_initial_value[0];
         alg_register_section.reg_crop_start_x = register_section.reg_map["reg_crop_start_x"].reg_initial_value[0];
@@ -61,12 +84,13 @@ public:
         alg_register_section.reg_dpc_threshold = register_section.reg_map["reg_dpc_threshold"].reg_initial_value[0];
     }
 
-    void loadImageSection(const ImageSection& image_section) {
+    // the source image paths live in output_info next to the other data paths
+    void loadImageSection(const ImageSection& image_section, const OutputSection& output_section) {
         // image info
         MAIN_INFO_1("Image Section loading...");
-        alg_image_section.image_path = image_section.image_path;
-        alg_image_section.random_image_path = image_section.random_image_path;
-        alg_image_section.generate_random_image = image_section.generate_random_image;
+        alg_image_section.image_path = output_section.src_image_path;
+        alg_image_section.random_image_path = output_section.random_src_image_path;
+        alg_image_section.generate_random_image = image_section.generate_random_src_image_enable;
     }
 
     void loadOutputSection(const OutputSection& output_section) {
@@ -80,7 +104,7 @@ public:
 
     void loadSection(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
         loadRegisterSection(register_section);
-        loadImageSection(image_section);
+        loadImageSection(image_section, output_section);
         loadOutputSection(output_section);
     }
 
@@ -88,9 +112,9 @@ public:
     void loadImage() {
         MAIN_INFO_1("Image loading...");
         if (alg_image_section.generate_random_image) {
-            alg_input_image = vector_read_from_file<ALG_INPUT_DATA_TYPE>(alg_image_section.random_image_path);
+            vector_read_from_file(alg_image_section.random_image_path, alg_input_image);
         } else {
-            alg_input_image = vector_read_from_file<ALG_INPUT_DATA_TYPE>(alg_image_section.image_path);
+            vector_read_from_file(alg_image_section.image_path, alg_input_image);
         }
     }
 
@@ -130,6 +154,66 @@ public:
     }
 
 
+    void process(const frame_vector<ALG_INPUT_DATA_TYPE>& input_image) {
+        process(input_image, vector_hash64(input_image));
+    }
+
+    // [dpc ->] crop, a stage only re-runs when its input key or its own registers changed
+    void process(const frame_vector<ALG_INPUT_DATA_TYPE>& input_image, uint64_t input_hash) {
+        if (!alg_dpc_stage_enable) {
+            alg_dpc_rerun = false;
+            alg_dpc_cache.invalidate();
+            alg_dpc_output_image.clear();
+            processCrop(input_image, input_hash);
+            return;
+        }
+
+        uint64_t dpc_key = AlgDpc<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::register_hash(alg_register_section, input_hash);
+        alg_dpc_rerun = !selectCache(alg_dpc_cache, dpc_key, alg_dpc_output_image);
+        if (alg_dpc_rerun) {
+            alg_dpc.run(input_image, alg_dpc_output_image, alg_register_section);
+        }
+
+        // the dpc key identifies the dpc output, so it stands in for the crop input hash
+        processCrop(alg_dpc_output_image, dpc_key);
+    }
+
+    void processCrop(const frame_vector<ALG_OUTPUT_DATA_TYPE>& crop_input_image, uint64_t crop_input_key) {
+        uint64_t crop_key = AlgCrop<ALG_OUTPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE>::register_hash(alg_register_section, crop_input_key);
+        alg_crop_rerun = !selectCache(alg_crop_cache, crop_key, alg_crop_output_image);
+        if (alg_crop_rerun) {
+            alg_crop.run(crop_input_image, alg_crop_output_image, alg_register_section);
+        }
+    }
+
+    // true when output_image already holds the stage output for key
+    bool selectCache(AlgStageCache<ALG_OUTPUT_DATA_TYPE>& stage_cache, uint64_t key, frame_vector<ALG_OUTPUT_DATA_TYPE>& output_image) {
+        if (!alg_stage_cache_enable) {
+            stage_cache.clear();
+            return false;
+        }
+        return stage_cache.select(key, output_image);
+    }
+
+    int getOutputWidth() const {
+        if (!alg_register_section.reg_crop_enable) {
+            return alg_register_section.reg_image_width;
+        }
+        return alg_register_section.reg_crop_end_x - alg_register_section.reg_crop_start_x + 1;
+    }
+
+    int getOutputHeight() const {
+        if (!alg_register_section.reg_crop_enable) {
+            return alg_register_section.reg_image_height;
+        }
+        return alg_register_section.reg_crop_end_y - alg_register_section.reg_crop_start_y + 1;
+    }
+
+    // final output of the last run, the crop stage output (no full-frame copy per run)
+    const frame_vector<ALG_OUTPUT_DATA_TYPE>& getOutputImage() const {
+        return alg_crop_output_image;
+    }
+
     void run(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
         // alg initialize
         MAIN_INFO_1("AlgTop initialize...");
@@ -139,22 +223,79 @@ public:
 
         // alg run
         MAIN_INFO_1("alg run...");
-        vector<ALG_INPUT_DATA_TYPE> alg_crop_input_image;
-        vector<ALG_OUTPUT_DATA_TYPE> alg_crop_output_image;
-        alg_crop_input_image = alg_input_image;
-        MAIN_INFO_1("alg crop run...");
-        alg_crop.run(alg_crop_input_image, alg_crop_output_image, alg_register_section);
-        MAIN_INFO_1("crop output data save to: " + alg_output_section.alg_crop_output_path);
+        alg_input_hash = vector_hash64(alg_input_image);
+        process(alg_input_image, alg_input_hash);
+        writeOutput();
+        
+        MAIN_INFO_1("alg run completed");
+    }
+
+    // multi-frame run, frame N+1.. are read and decoded in the background while frame N computes
+    void runFrameList(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section,
+                      const vector<string>& frame_path_list, int prefetch_queue_depth, size_t prefetch_memory_budget) {
+        // alg initialize
+        MAIN_INFO_1("AlgTop initialize...");
+        loadSection(register_section, image_section, output_section);
+        printSection();
+
+        // alg run
+        MAIN_INFO_1("alg run, frame num: " + to_string(frame_path_list.size()));
+        AlgOutputSection frame_output_section = alg_output_section;
+        ImagePrefetcher<ALG_INPUT_DATA_TYPE> image_prefetcher(frame_path_list, prefetch_queue_depth, prefetch_memory_budget);
+        string frame_path;
+        for (int frame_index = 0; image_prefetcher.next(alg_input_image, frame_path); frame_index++) {
+            MAIN_INFO_1("frame " + to_string(frame_index) + ": " + frame_path);
+            alg_input_hash = vector_hash64(alg_input_image);
+            process(alg_input_image, alg_input_hash);
+            alg_output_section.alg_dpc_output_path = getFramePath(frame_output_section.alg_dpc_output_path, frame_index);
+            alg_output_section.alg_crop_output_path = getFramePath(frame_output_section.alg_crop_output_path, frame_index);
+            writeOutput();
+        }
+        alg_output_section = frame_output_section;
+        MAIN_INFO_1("prefetch wait count: " + to_string(image_prefetcher.waitCount()));
+
+        MAIN_INFO_1("alg run completed");
+    }
 
-        int crop_image_width = alg_register_section.reg_crop_end_x - alg_register_section.reg_crop_start_x + 1;
-        int crop_image_height = alg_register_section.reg_crop_end_y - alg_register_section.reg_crop_start_y + 1;
+    // data/xxx.txt -> data/xxx_0003.txt
+    static string getFramePath(const string& path, int frame_index) {
+        ostringstream oss;
+        oss << "_" << setw(4) << setfill('0') << frame_index;
+        size_t dot_pos = path.find_last_of('.');
+        size_t slash_pos = path.find_last_of('/');
+        if (dot_pos == string::npos || (slash_pos != string::npos && dot_pos < slash_pos)) {
+            return path + oss.str();
+        }
+        return path.substr(0, dot_pos) + oss.str() + path.substr(dot_pos);
+    }
+
+    // interactive tuning: reload registers and recompute only the stages they affect
+    void update(RegisterSection& register_section) {
+        parseRegisterSection(register_section, alg_register_section);
+        process(alg_input_image, alg_input_hash);
+        if (alg_dpc_stage_enable) {
+            MAIN_INFO_1(string("alg dpc ") + (alg_dpc_rerun ? "recomputed" : "reused from cache"));
+        }
+        MAIN_INFO_1(string("alg crop ") + (alg_crop_rerun ? "recomputed" : "reused from cache"));
+        writeOutput();
+    }
+
+    void writeOutput() {
+        if (alg_dpc_stage_enable) {
+            MAIN_INFO_1("dpc output data save to: " + alg_output_section.alg_dpc_output_path);
+            vector_write_to_file<ALG_OUTPUT_DATA_TYPE>(alg_output_section.alg_dpc_output_path, alg_dpc_output_image, alg_register_section.reg_image_width, alg_register_section.reg_image_height);
+            hash_manifest_write_for(alg_output_section.alg_dpc_output_path, alg_dpc_output_image, alg_register_section.reg_image_width, alg_register_section.reg_image_height);
+        } else {
+            hash_manifest_remove_for(alg_output_section.alg_dpc_output_path);
+        }
+
+        int crop_image_width = getOutputWidth();
+        int crop_image_height = getOutputHeight();
         MAIN_INFO_1("alg crop output image width: " + std::to_string(crop_image_width));
         MAIN_INFO_1("alg crop output image height: " + std::to_string(crop_image_height));
-
+        MAIN_INFO_1("crop output data save to: " + alg_output_section.alg_crop_output_path);
         vector_write_to_file<ALG_OUTPUT_DATA_TYPE>(alg_output_section.alg_crop_output_path, alg_crop_output_image, crop_image_width, crop_image_height);
-        alg_output_image = alg_crop_output_image;
-        
-        MAIN_INFO_1("alg run completed");
+        hash_manifest_write_for(alg_output_section.alg_crop_output_path, alg_crop_output_image, crop_image_width, crop_image_height);
     }
 
 
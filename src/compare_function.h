@@ -0,0 +1,628 @@
+#ifndef COMPARE_FUNCTION_H
+#define COMPARE_FUNCTION_H
+
+// full-mismatch comparison of two output files (alg vs hls golden)
+//  - files are mmapped, text dumps are parsed in parallel byte ranges split on line starts, raw
+//    binary dumps (.raw / .bin, little endian samples) are compared straight from the mapping
+//  - the frame is cut into bands of tile rows, each band is compared by one worker, the per pixel
+//    loop is branch free (abs diff, mismatch count, sum, max) so the compiler vectorizes it
+//  - the result carries mismatch count, max / mean absolute difference, per-row and per-tile
+//    mismatch histograms and the first max_report coordinates in raster order
+// text format as vector_write_to_file: one or more values per line, '#' starts a comment,
+// hex by default (the alg / hls / py dumps are "%04x  # (row, col)"), the width is taken from the
+// coordinate comments when it is not given
+// hash manifests (hash_manifest_function.h): when both files have an up to date <path>.hash of the
+// same size, only the tiles whose hashes differ are read (raw files and fixed width text lines are
+// random access), equal manifests pass without touching the pixels
+
+// std
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+// posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// tool
+#include "print_function.h"
+#include "hash_manifest_function.h"
+
+// def
+#define COMPARE_FUNCTION_SECTION    "[compare_function]"
+#define COMPARE_MAX_REPORT          16
+#define COMPARE_TILE_SIZE           64
+#define COMPARE_TILE_MAP_MAX        128     // tiles per side up to which the tile map is printed
+
+// using
+using namespace std;
+
+
+// read-only mapping of a whole file, empty files map to nullptr / 0
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), size(0), fd(-1) {}
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const string& path) {
+        close();
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close();
+            return false;
+        }
+        size = (size_t)st.st_size;
+        if (size > 0) {
+            void* addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                close();
+                return false;
+            }
+            madvise(addr, size, MADV_SEQUENTIAL);
+            data = static_cast<const char*>(addr);
+        }
+        return true;
+    }
+
+    void close() {
+        if (data) {
+            munmap(const_cast<char*>(data), size);
+        }
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        data = nullptr;
+        size = 0;
+        fd = -1;
+    }
+
+    const char* data;
+    size_t size;
+
+private:
+    int fd;
+};
+
+
+struct CompareOption {
+    int thread_num = 0;                 // 0: hardware concurrency
+    int width = 0;                      // 0: from the coordinate comments, else one row
+    int radix = 16;                     // text values, 16 or 10
+    int sample_bytes = 2;               // raw binary samples, 1 or 2
+    int tile_size = COMPARE_TILE_SIZE;
+    size_t max_report = COMPARE_MAX_REPORT;
+    bool manifest_enable = true;        // use the <path>.hash manifests when both are present
+};
+
+struct CompareMismatch {
+    size_t index;
+    int x;
+    int y;
+    int32_t alg_value;
+    int32_t hls_value;
+};
+
+struct CompareResult {
+    bool load_ok = false;
+    size_t alg_size = 0;
+    size_t hls_size = 0;
+    int width = 0;
+    int height = 0;
+    size_t mismatch_num = 0;
+    uint32_t max_abs_diff = 0;
+    uint64_t sum_abs_diff = 0;
+    vector<uint32_t> row_mismatch;          // per row
+    int tile_size = COMPARE_TILE_SIZE;
+    int tile_x_num = 0;
+    int tile_y_num = 0;
+    vector<uint32_t> tile_mismatch;         // tile_y_num x tile_x_num
+    vector<CompareMismatch> first_mismatch; // raster order, at most max_report
+    bool manifest_used = false;             // only the tiles with differing hashes were read
+    size_t manifest_tile_read = 0;
+
+    bool pass() const { return load_ok && alg_size == hls_size && mismatch_num == 0; }
+    double mean_abs_diff() const { return alg_size ? (double)sum_abs_diff / min(alg_size, hls_size) : 0.0; }
+};
+
+
+inline int compare_thread_num(int thread_num) {
+    return thread_num > 0 ? thread_num : max(1, (int)std::thread::hardware_concurrency());
+}
+
+// runs task(i) for i in [0, task_num) on up to thread_num workers
+template <typename TASK>
+void compare_parallel_for(size_t task_num, int thread_num, TASK task) {
+    int worker_num = (int)min<size_t>((size_t)compare_thread_num(thread_num), task_num);
+    if (worker_num <= 1) {
+        for (size_t i = 0; i < task_num; i++) {
+            task(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next_task(0);
+    vector<std::thread> worker_list;
+    for (int t = 0; t < worker_num; t++) {
+        worker_list.push_back(std::thread([&]() {
+            for (size_t i = next_task++; i < task_num; i = next_task++) {
+                task(i);
+            }
+        }));
+    }
+    for (size_t t = 0; t < worker_list.size(); t++) {
+        worker_list[t].join();
+    }
+}
+
+
+inline bool compare_is_raw_path(const string& path) {
+    size_t dot_pos = path.find_last_of('.');
+    if (dot_pos == string::npos) {
+        return false;
+    }
+    string ext = path.substr(dot_pos + 1);
+    for (size_t i = 0; i < ext.size(); i++) {
+        ext[i] = (char)tolower((unsigned char)ext[i]);
+    }
+    return ext == "raw" || ext == "bin";
+}
+
+inline int compare_digit(char c, int radix) {
+    int d = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : (c >= 'A' && c <= 'F') ? c - 'A' + 10 : 99;
+    return d < radix ? d : -1;
+}
+
+// values of text[begin, end), both on line starts
+inline void compare_parse_text_range(const char* text, size_t begin, size_t end, int radix, vector<int32_t>& value) {
+    size_t i = begin;
+    while (i < end) {
+        char c = text[i];
+        if (c == '#') {
+            while (i < end && text[i] != '\n') {
+                i++;
+            }
+            continue;
+        }
+        int d = compare_digit(c, radix);
+        if (d < 0) {
+            i++;
+            continue;
+        }
+        int32_t v = 0;
+        if (radix == 16 && c == '0' && i + 1 < end && (text[i + 1] == 'x' || text[i + 1] == 'X')) {
+            i += 2;
+        }
+        while (i < end && (d = compare_digit(text[i], radix)) >= 0) {
+            v = v * radix + d;
+            i++;
+        }
+        value.push_back(v);
+    }
+}
+
+// width from the "# (a, b)" comments of the first row: the coordinate that stays constant over the
+// first row runs for width lines, whichever order the writer used, 0 when there are no comments
+inline int compare_text_width(const char* text, size_t size) {
+    int first[2] = {0, 0};
+    int run[2] = {0, 0};
+    bool done[2] = {false, false};
+    size_t line_num = 0;
+    size_t i = 0;
+    while (i < size && !(done[0] && done[1])) {
+        size_t line_end = i;
+        while (line_end < size && text[line_end] != '\n') {
+            line_end++;
+        }
+        // the mapping is not NUL terminated, sscanf works on a copy of the comment
+        const char* comment = (const char*)memchr(text + i, '(', line_end - i);
+        char comment_buffer[64] = {0};
+        if (comment) {
+            memcpy(comment_buffer, comment, min<size_t>(sizeof(comment_buffer) - 1, text + line_end - comment));
+        }
+        int a, b;
+        if (comment && sscanf(comment_buffer, "(%d ,%d", &a, &b) == 2) {
+            int coord[2] = {a, b};
+            for (int k = 0; k < 2; k++) {
+                if (line_num == 0) {
+                    first[k] = coord[k];
+                }
+                if (!done[k] && coord[k] == first[k]) {
+                    run[k]++;
+                } else {
+                    done[k] = true;
+                }
+            }
+            line_num++;
+        } else if (memchr(text + i, '#', line_end - i) == nullptr && line_end > i) {
+            return 0;   // a value line without coordinates
+        }
+        i = line_end + 1;
+    }
+    return max(run[0], run[1]);
+}
+
+// text file -> values, parsed in thread_num byte ranges
+inline bool compare_load_text(const MappedFile& file, int radix, int thread_num, vector<int32_t>& value) {
+    size_t part_num = (size_t)compare_thread_num(thread_num);
+    vector<size_t> cut(part_num + 1, file.size);
+    cut[0] = 0;
+    for (size_t p = 1; p < part_num; p++) {
+        size_t pos = max(cut[p - 1], file.size * p / part_num);
+        while (pos < file.size && pos > 0 && file.data[pos - 1] != '\n') {
+            pos++;
+        }
+        cut[p] = pos;
+    }
+    vector<vector<int32_t>> part_value(part_num);
+    compare_parallel_for(part_num, thread_num, [&](size_t p) {
+        part_value[p].reserve((cut[p + 1] - cut[p]) / 8 + 1);
+        compare_parse_text_range(file.data, cut[p], cut[p + 1], radix, part_value[p]);
+    });
+    size_t total = 0;
+    for (size_t p = 0; p < part_num; p++) {
+        total += part_value[p].size();
+    }
+    value.clear();
+    value.reserve(total);
+    for (size_t p = 0; p < part_num; p++) {
+        value.insert(value.end(), part_value[p].begin(), part_value[p].end());
+    }
+    return true;
+}
+
+
+// samples x0 .. x0 + n - 1 of row y (a / b point at sample x0), branch free, the sums and the first
+// max_report mismatches go to segment_result, returns the mismatch count
+template <typename A, typename B>
+uint32_t compare_segment(const A* a, const B* b, int n, int x0, int y, size_t row_start, CompareResult& segment_result,
+                         size_t max_report) {
+    uint32_t mismatch_num = 0;
+    uint64_t sum = 0;
+    uint32_t max_diff = 0;
+    for (int k = 0; k < n; k++) {
+        int32_t d = (int32_t)a[k] - (int32_t)b[k];
+        uint32_t ad = (uint32_t)(d < 0 ? -d : d);
+        mismatch_num += (ad != 0);
+        sum += ad;
+        max_diff = max(max_diff, ad);
+    }
+    if (mismatch_num == 0) {
+        return 0;
+    }
+    segment_result.sum_abs_diff += sum;
+    segment_result.max_abs_diff = max(segment_result.max_abs_diff, max_diff);
+    for (int k = 0; k < n && segment_result.first_mismatch.size() < max_report; k++) {
+        if ((int32_t)a[k] != (int32_t)b[k]) {
+            CompareMismatch mismatch;
+            mismatch.index = row_start + x0 + k;
+            mismatch.x = x0 + k;
+            mismatch.y = y;
+            mismatch.alg_value = (int32_t)a[k];
+            mismatch.hls_value = (int32_t)b[k];
+            segment_result.first_mismatch.push_back(mismatch);
+        }
+    }
+    return mismatch_num;
+}
+
+// one band of whole rows [y_begin, y_end) of two sample arrays, row_mismatch / tile_mismatch of the
+// band only touched here, band_result.first_mismatch holds the band's first max_report
+template <typename A, typename B>
+void compare_band(const A* alg, const B* hls, int width, int y_begin, int y_end, size_t size, CompareResult& result,
+                  CompareResult& band_result, size_t max_report) {
+    for (int y = y_begin; y < y_end; y++) {
+        size_t row_start = (size_t)y * width;
+        int row_width = (int)min<size_t>((size_t)width, size - row_start);
+        uint32_t row_mismatch = 0;
+        for (int x0 = 0; x0 < row_width; x0 += result.tile_size) {
+            int x1 = min(row_width, x0 + result.tile_size);
+            uint32_t tile_mismatch = compare_segment(alg + row_start + x0, hls + row_start + x0, x1 - x0, x0, y, row_start,
+                                                     band_result, max_report);
+            row_mismatch += tile_mismatch;
+            result.tile_mismatch[(size_t)(y / result.tile_size) * result.tile_x_num + x0 / result.tile_size] += tile_mismatch;
+        }
+        result.row_mismatch[y] = row_mismatch;
+        band_result.mismatch_num += row_mismatch;
+    }
+}
+
+// compares the first min(alg_size, hls_size) samples, bands of tile rows in parallel
+template <typename A, typename B>
+void compare_samples(const A* alg, size_t alg_size, const B* hls, size_t hls_size, const CompareOption& option, CompareResult& result) {
+    size_t size = min(alg_size, hls_size);
+    result.alg_size = alg_size;
+    result.hls_size = hls_size;
+    result.tile_size = max(1, option.tile_size);
+    result.width = (option.width > 0) ? option.width : (int)max<size_t>(1, size);
+    result.height = (int)((size + result.width - 1) / result.width);
+    result.tile_x_num = (result.width + result.tile_size - 1) / result.tile_size;
+    result.tile_y_num = (result.height + result.tile_size - 1) / result.tile_size;
+    result.row_mismatch.assign(result.height, 0);
+    result.tile_mismatch.assign((size_t)result.tile_x_num * result.tile_y_num, 0);
+
+    // a band is a whole number of tile rows, so every tile belongs to one band
+    int band_rows = result.tile_size;
+    size_t band_num = (size_t)result.tile_y_num;
+    vector<CompareResult> band_result(band_num);
+    compare_parallel_for(band_num, option.thread_num, [&](size_t band) {
+        int y_begin = (int)band * band_rows;
+        int y_end = min(result.height, y_begin + band_rows);
+        compare_band(alg, hls, result.width, y_begin, y_end, size, result, band_result[band], option.max_report);
+    });
+
+    for (size_t band = 0; band < band_num; band++) {
+        result.mismatch_num += band_result[band].mismatch_num;
+        result.sum_abs_diff += band_result[band].sum_abs_diff;
+        result.max_abs_diff = max(result.max_abs_diff, band_result[band].max_abs_diff);
+        for (size_t i = 0; i < band_result[band].first_mismatch.size() && result.first_mismatch.size() < option.max_report; i++) {
+            result.first_mismatch.push_back(band_result[band].first_mismatch[i]);
+        }
+    }
+}
+
+
+// random access to sample i of a mapped dump: raw samples, or text with one value per line and
+// every line the same length (vector_write_to_file), line_length 0 when the text is not fixed width
+struct CompareSampleReader {
+    const MappedFile* file = nullptr;
+    bool raw = false;
+    int sample_bytes = 2;
+    int radix = 16;
+    size_t line_length = 0;
+    bool ok = true;
+
+    bool open(const MappedFile& mapped_file, bool raw_file, const CompareOption& option, size_t sample_num) {
+        file = &mapped_file;
+        raw = raw_file;
+        sample_bytes = (option.sample_bytes == 1) ? 1 : 2;
+        radix = option.radix;
+        if (raw) {
+            return file->size == sample_num * sample_bytes;
+        }
+        const char* line_end = (const char*)memchr(file->data, '\n', file->size);
+        line_length = line_end ? (size_t)(line_end - file->data) + 1 : 0;
+        return line_length > 0 && file->size == line_length * sample_num;
+    }
+
+    int32_t operator()(size_t i) {
+        if (raw) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(file->data) + i * sample_bytes;
+            return (sample_bytes == 1) ? p[0] : (int32_t)(p[0] | (p[1] << 8));
+        }
+        const char* line = file->data + i * line_length;
+        ok = ok && line[line_length - 1] == '\n';
+        size_t k = 0;
+        while (k < line_length && (line[k] == ' ' || line[k] == '\t')) {
+            k++;
+        }
+        if (radix == 16 && k + 1 < line_length && line[k] == '0' && (line[k + 1] == 'x' || line[k + 1] == 'X')) {
+            k += 2;
+        }
+        int32_t v = 0;
+        int d;
+        while (k < line_length && (d = compare_digit(line[k], radix)) >= 0) {
+            v = v * radix + d;
+            k++;
+        }
+        return v;
+    }
+};
+
+// manifest-first compare, false when the files cannot be read tile by tile (the caller then does
+// the full compare)
+inline bool compare_file_manifest(const MappedFile& alg_file, const MappedFile& hls_file, bool raw,
+                                  const HashManifest& alg_manifest, const HashManifest& hls_manifest,
+                                  const CompareOption& option, CompareResult& result) {
+    size_t sample_num = (size_t)alg_manifest.width * alg_manifest.height;
+    CompareSampleReader alg_reader;
+    CompareSampleReader hls_reader;
+    if (!alg_reader.open(alg_file, raw, option, sample_num) || !hls_reader.open(hls_file, raw, option, sample_num)) {
+        return false;
+    }
+
+    result.alg_size = sample_num;
+    result.hls_size = sample_num;
+    result.width = alg_manifest.width;
+    result.height = alg_manifest.height;
+    result.tile_size = alg_manifest.tile_size;
+    result.tile_x_num = alg_manifest.tile_x_num;
+    result.tile_y_num = alg_manifest.tile_y_num;
+    result.row_mismatch.assign(result.height, 0);
+    result.tile_mismatch.assign((size_t)result.tile_x_num * result.tile_y_num, 0);
+    result.manifest_used = true;
+
+    vector<size_t> tile_list;
+    if (alg_manifest.frame_hash != hls_manifest.frame_hash || alg_manifest.tile_hash != hls_manifest.tile_hash) {
+        for (size_t t = 0; t < alg_manifest.tile_hash.size(); t++) {
+            if (alg_manifest.tile_hash[t] != hls_manifest.tile_hash[t]) {
+                tile_list.push_back(t);
+            }
+        }
+    }
+    result.manifest_tile_read = tile_list.size();
+
+    // one worker per differing tile, row counts of a tile are merged afterwards (tiles share rows)
+    vector<CompareResult> tile_result(tile_list.size());
+    vector<vector<uint32_t>> tile_row_mismatch(tile_list.size());
+    vector<uint8_t> tile_ok(tile_list.size(), 1);
+    compare_parallel_for(tile_list.size(), option.thread_num, [&](size_t k) {
+        int tx = (int)(tile_list[k] % result.tile_x_num);
+        int ty = (int)(tile_list[k] / result.tile_x_num);
+        int x0 = tx * result.tile_size;
+        int x1 = min(result.width, x0 + result.tile_size);
+        int y0 = ty * result.tile_size;
+        int y1 = min(result.height, y0 + result.tile_size);
+        CompareSampleReader alg_tile_reader = alg_reader;
+        CompareSampleReader hls_tile_reader = hls_reader;
+        vector<int32_t> alg_row(x1 - x0);
+        vector<int32_t> hls_row(x1 - x0);
+        tile_row_mismatch[k].assign(y1 - y0, 0);
+        for (int y = y0; y < y1; y++) {
+            size_t row_start = (size_t)y * result.width;
+            for (int x = x0; x < x1; x++) {
+                alg_row[x - x0] = alg_tile_reader(row_start + x);
+                hls_row[x - x0] = hls_tile_reader(row_start + x);
+            }
+            uint32_t mismatch_num = compare_segment(alg_row.data(), hls_row.data(), x1 - x0, x0, y, row_start,
+                                                    tile_result[k], option.max_report);
+            tile_row_mismatch[k][y - y0] = mismatch_num;
+            tile_result[k].mismatch_num += mismatch_num;
+        }
+        tile_ok[k] = alg_tile_reader.ok && hls_tile_reader.ok;
+        result.tile_mismatch[tile_list[k]] = (uint32_t)tile_result[k].mismatch_num;
+    });
+
+    for (size_t k = 0; k < tile_list.size(); k++) {
+        if (!tile_ok[k]) {
+            return false;   // a line of another length, not a fixed width dump
+        }
+        int y0 = (int)(tile_list[k] / result.tile_x_num) * result.tile_size;
+        for (size_t r = 0; r < tile_row_mismatch[k].size(); r++) {
+            result.row_mismatch[y0 + r] += tile_row_mismatch[k][r];
+        }
+        result.mismatch_num += tile_result[k].mismatch_num;
+        result.sum_abs_diff += tile_result[k].sum_abs_diff;
+        result.max_abs_diff = max(result.max_abs_diff, tile_result[k].max_abs_diff);
+        result.first_mismatch.insert(result.first_mismatch.end(), tile_result[k].first_mismatch.begin(), tile_result[k].first_mismatch.end());
+    }
+    sort(result.first_mismatch.begin(), result.first_mismatch.end(),
+         [](const CompareMismatch& a, const CompareMismatch& b) { return a.index < b.index; });
+    if (result.first_mismatch.size() > option.max_report) {
+        result.first_mismatch.resize(option.max_report);
+    }
+    result.load_ok = true;
+    return true;
+}
+
+
+// alg_path vs hls_path, text or raw binary by extension
+inline CompareResult compare_file(const string& alg_path, const string& hls_path, const CompareOption& option) {
+    CompareResult result;
+    MappedFile alg_file;
+    MappedFile hls_file;
+    if (!alg_file.open(alg_path)) {
+        main_info(COMPARE_FUNCTION_SECTION, "Cannot open file: " + alg_path);
+        return result;
+    }
+    if (!hls_file.open(hls_path)) {
+        main_info(COMPARE_FUNCTION_SECTION, "Cannot open file: " + hls_path);
+        return result;
+    }
+
+    bool raw = compare_is_raw_path(alg_path) && compare_is_raw_path(hls_path);
+    HashManifest alg_manifest;
+    HashManifest hls_manifest;
+    if (option.manifest_enable && hash_manifest_load(alg_path, alg_manifest) && hash_manifest_load(hls_path, hls_manifest)
+        && alg_manifest.width == hls_manifest.width && alg_manifest.height == hls_manifest.height
+        && alg_manifest.tile_size == hls_manifest.tile_size) {
+        if (compare_file_manifest(alg_file, hls_file, raw, alg_manifest, hls_manifest, option, result)) {
+            return result;
+        }
+        result = CompareResult();
+    }
+
+    CompareOption file_option = option;
+    if (raw) {
+        size_t sample_bytes = (option.sample_bytes == 1) ? 1 : 2;
+        if (sample_bytes == 1) {
+            compare_samples(reinterpret_cast<const uint8_t*>(alg_file.data), alg_file.size,
+                            reinterpret_cast<const uint8_t*>(hls_file.data), hls_file.size, file_option, result);
+        } else {
+            compare_samples(reinterpret_cast<const uint16_t*>(alg_file.data), alg_file.size / 2,
+                            reinterpret_cast<const uint16_t*>(hls_file.data), hls_file.size / 2, file_option, result);
+        }
+        result.load_ok = true;
+        return result;
+    }
+
+    vector<int32_t> alg_value;
+    vector<int32_t> hls_value;
+    std::thread alg_loader([&]() { compare_load_text(alg_file, option.radix, option.thread_num, alg_value); });
+    compare_load_text(hls_file, option.radix, option.thread_num, hls_value);
+    alg_loader.join();
+    if (file_option.width <= 0) {
+        file_option.width = compare_text_width(alg_file.data, alg_file.size);
+    }
+    compare_samples(alg_value.data(), alg_value.size(), hls_value.data(), hls_value.size(), file_option, result);
+    result.load_ok = true;
+    return result;
+}
+
+
+// summary, first mismatches, rows with mismatches and a tile map ('.' clean, 1-9 log2 of the
+// tile mismatch count, '#' beyond)
+inline void compare_print(const string& section, const string& name, const CompareResult& result, size_t max_row_report = COMPARE_MAX_REPORT) {
+    char line[512];
+    if (!result.load_ok) {
+        snprintf(line, sizeof(line), "%s: FAIL, cannot load", name.c_str());
+        main_info(section, line);
+        return;
+    }
+    snprintf(line, sizeof(line), "%s: %s, %dx%d, alg %zu / hls %zu samples, %zu mismatches (%.4f%%), max abs diff %u, mean abs diff %.6f",
+             name.c_str(), result.pass() ? "PASS" : "FAIL", result.width, result.height, result.alg_size, result.hls_size,
+             result.mismatch_num, result.alg_size ? 100.0 * result.mismatch_num / min(result.alg_size, result.hls_size) : 0.0,
+             result.max_abs_diff, result.mean_abs_diff());
+    main_info(section, line);
+    if (result.manifest_used) {
+        main_info(section, "  hash manifest: " + to_string(result.manifest_tile_read) + "/" + to_string(result.tile_mismatch.size())
+                           + " tiles differ, only those were read");
+    }
+    if (result.mismatch_num == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < result.first_mismatch.size(); i++) {
+        const CompareMismatch& mismatch = result.first_mismatch[i];
+        snprintf(line, sizeof(line), "  (x=%d, y=%d) alg=0x%04x hls=0x%04x diff=%d", mismatch.x, mismatch.y,
+                 (unsigned)mismatch.alg_value, (unsigned)mismatch.hls_value, mismatch.hls_value - mismatch.alg_value);
+        main_info(section, line);
+    }
+
+    size_t bad_row_num = 0;
+    string row_list;
+    for (size_t y = 0; y < result.row_mismatch.size(); y++) {
+        if (result.row_mismatch[y] == 0) {
+            continue;
+        }
+        if (bad_row_num < max_row_report) {
+            row_list += " " + to_string(y) + ":" + to_string(result.row_mismatch[y]);
+        }
+        bad_row_num++;
+    }
+    main_info(section, "  rows with mismatches: " + to_string(bad_row_num) + "/" + to_string(result.row_mismatch.size())
+                       + " (row:count)" + row_list + (bad_row_num > max_row_report ? " ..." : ""));
+
+    if (result.tile_x_num > COMPARE_TILE_MAP_MAX || result.tile_y_num > COMPARE_TILE_MAP_MAX) {
+        return;
+    }
+    main_info(section, "  tile map, " + to_string(result.tile_size) + "x" + to_string(result.tile_size) + " tiles, "
+                       + to_string(result.tile_x_num) + "x" + to_string(result.tile_y_num) + ":");
+    for (int ty = 0; ty < result.tile_y_num; ty++) {
+        string map_row = "    ";
+        for (int tx = 0; tx < result.tile_x_num; tx++) {
+            uint32_t n = result.tile_mismatch[(size_t)ty * result.tile_x_num + tx];
+            int level = 0;
+            while (n > 0) {
+                level++;
+                n >>= 1;
+            }
+            map_row += (level == 0) ? '.' : (level <= 9) ? (char)('0' + level) : '#';
+        }
+        main_info(section, map_row);
+    }
+}
+
+
+#endif // COMPARE_FUNCTION_H
@@ -0,0 +1,121 @@
+#ifndef CROSS_CHECK_FUNCTION_H
+#define CROSS_CHECK_FUNCTION_H
+
+// in-memory bit-exact comparison of one stage output of the alg and the hls model
+// both images are row major width x height, the first max_report differing pixels are kept with
+// their coordinates, the rest are only counted
+
+// std
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <cctype>
+
+// tool
+#include "print_function.h"
+
+// def
+#define CROSS_CHECK_FUNCTION_SECTION    "[cross_check_function]"
+#define CROSS_CHECK_MAX_REPORT          8
+
+// using
+using namespace std;
+
+
+struct CrossCheckMismatch {
+    int x;
+    int y;
+    int64_t alg_value;
+    int64_t hls_value;
+};
+
+struct CrossCheckResult {
+    string stage;
+    int width;
+    int height;
+    size_t alg_size;
+    size_t hls_size;
+    size_t mismatch_num;
+    vector<CrossCheckMismatch> first_mismatch;     // raster order, at most max_report
+
+    bool pass() const {
+        return alg_size == hls_size && mismatch_num == 0;
+    }
+};
+
+
+// pixels past the shorter image are not compared, a size difference alone fails the stage
+template <typename ALG_IMAGE, typename HLS_IMAGE>
+CrossCheckResult cross_check_image(const string& stage, const ALG_IMAGE& alg_image, const HLS_IMAGE& hls_image,
+                                   int width, int height, size_t max_report = CROSS_CHECK_MAX_REPORT) {
+    CrossCheckResult result;
+    result.stage = stage;
+    result.width = width;
+    result.height = height;
+    result.alg_size = alg_image.size();
+    result.hls_size = hls_image.size();
+    result.mismatch_num = 0;
+
+    size_t size = (alg_image.size() < hls_image.size()) ? alg_image.size() : hls_image.size();
+    for (size_t i = 0; i < size; i++) {
+        if (static_cast<int64_t>(alg_image[i]) == static_cast<int64_t>(hls_image[i])) {
+            continue;
+        }
+        if (result.mismatch_num < max_report) {
+            CrossCheckMismatch mismatch;
+            mismatch.x = width > 0 ? (int)(i % width) : (int)i;
+            mismatch.y = width > 0 ? (int)(i / width) : 0;
+            mismatch.alg_value = static_cast<int64_t>(alg_image[i]);
+            mismatch.hls_value = static_cast<int64_t>(hls_image[i]);
+            result.first_mismatch.push_back(mismatch);
+        }
+        result.mismatch_num++;
+    }
+    return result;
+}
+
+
+inline void cross_check_print(const string& section, const CrossCheckResult& result) {
+    char line[256];
+    if (result.pass()) {
+        snprintf(line, sizeof(line), "%s %dx%d: PASS", result.stage.c_str(), result.width, result.height);
+        main_info(section, line);
+        return;
+    }
+    snprintf(line, sizeof(line), "%s %dx%d: FAIL, alg %zu / hls %zu pixels, %zu mismatches",
+             result.stage.c_str(), result.width, result.height, result.alg_size, result.hls_size, result.mismatch_num);
+    main_info(section, line);
+    for (size_t i = 0; i < result.first_mismatch.size(); i++) {
+        const CrossCheckMismatch& mismatch = result.first_mismatch[i];
+        snprintf(line, sizeof(line), "  (x=%d, y=%d) alg=%lld hls=%lld", mismatch.x, mismatch.y,
+                 (long long)mismatch.alg_value, (long long)mismatch.hls_value);
+        main_info(section, line);
+    }
+}
+
+
+// command line of the cross-check mains: a bad argument prints the usage and exits 1
+inline void cross_check_arg_error(const string& section, const string& usage, const string& message) {
+    main_info(section, usage);
+    main_error(section, message);
+}
+
+// strict decimal / 0x hex number in [min_value, max_value], atoi / strtoull would turn a typo into 0
+// and a 0 case run passes
+inline uint64_t cross_check_arg_number(const string& section, const string& usage, const string& name, const string& text,
+                                       uint64_t min_value, uint64_t max_value) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long value = isdigit((unsigned char)text.c_str()[0]) ? strtoull(text.c_str(), &end, 0) : 0;
+    if (end == nullptr || *end != '\0' || errno != 0 || value < min_value || value > max_value) {
+        cross_check_arg_error(section, usage, name + " must be a number in [" + to_string(min_value) + ", "
+                              + to_string(max_value) + "], got '" + text + "'");
+    }
+    return value;
+}
+
+
+#endif // CROSS_CHECK_FUNCTION_H
@@ -0,0 +1,370 @@
+#ifndef CROSS_CHECK_FUZZ_H
+#define CROSS_CHECK_FUZZ_H
+
+// randomized register fuzzing of AlgTop vs HlsTop, built on the in-memory cross-check
+//  - every register is drawn from its [cons_min, cons_max] in register_table.csv, the frame size is
+//    further capped to keep cases small, the crop window is then clamped into the frame
+//    (AlgCrop rejects windows outside the frame, the hardware behaviour there is unspecified)
+//  - case i of a campaign uses random_seed(seed, i), so every case reproduces alone (replay)
+//    whatever the thread count
+//  - cases run on a pool of worker threads, one AlgTop / HlsTop per thread, only the final
+//    (crop) output and the framing are compared in the campaign
+//  - failing cases are minimized: smaller sub-frames, stages disabled, threshold lowered and pixel
+//    blocks zeroed as long as the case keeps failing, then reported stage by stage
+
+// std
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+#include "random_function.h"
+#include "cross_check_function.h"
+#include "parse_csv_function.h"
+
+// ip
+#include "alg_info.h"
+#include "alg_top.h"
+#include "hls_top.h"
+
+// using
+using namespace std;
+
+// def
+#define CROSS_CHECK_FUZZ_SECTION            "CrossCheckFuzz"
+#define CROSS_CHECK_FUZZ_MAX_WIDTH          64
+#define CROSS_CHECK_FUZZ_MAX_HEIGHT         16
+#define CROSS_CHECK_FUZZ_MAX_FAIL           4       // campaign stops collecting after this many failures
+#define CROSS_CHECK_FUZZ_MINIMIZE_TRY_NUM   20000   // model runs per minimized case
+
+
+struct CrossCheckFuzzFail {
+    uint64_t case_index;
+    uint64_t case_seed;
+};
+
+
+template <typename T, int W>
+class CrossCheckFuzz {
+public:
+    typedef AlgTop<T, T> alg_top_t;
+    typedef HlsTop<T, T, W, W, HLS_AXIS_PACK_PPC(W)> hls_top_t;
+
+    CrossCheckFuzz() {};
+    ~CrossCheckFuzz() {};
+
+    // option
+    RegisterSection register_section;               // register table (LoadCSVFile), cons_min / cons_max bound the draws
+    int max_width = CROSS_CHECK_FUZZ_MAX_WIDTH;
+    int max_height = CROSS_CHECK_FUZZ_MAX_HEIGHT;
+    int max_fail = CROSS_CHECK_FUZZ_MAX_FAIL;
+    string fail_dir;                                // minimized failing inputs are written here when set
+
+    // result
+    uint64_t case_run = 0;
+    vector<CrossCheckFuzzFail> fail_list;
+
+
+    // registers and frame of one case, everything derived from case_seed
+    void generate(uint64_t case_seed, AlgRegisterSection& alg_regs, frame_vector<T>& input_image) const {
+        Xoshiro256ss gen(case_seed);
+        alg_regs.reg_image_width = (int)drawRegister(gen, "reg_image_width", 1, max_width);
+        alg_regs.reg_image_height = (int)drawRegister(gen, "reg_image_height", 1, max_height);
+        alg_regs.reg_crop_enable = drawRegister(gen, "reg_crop_enable", 0, 1) != 0;
+        alg_regs.reg_crop_start_x = (int)drawRegister(gen, "reg_crop_start_x", 0, 65535);
+        alg_regs.reg_crop_start_y = (int)drawRegister(gen, "reg_crop_start_y", 0, 65535);
+        alg_regs.reg_crop_end_x = (int)drawRegister(gen, "reg_crop_end_x", 0, 65535);
+        alg_regs.reg_crop_end_y = (int)drawRegister(gen, "reg_crop_end_y", 0, 65535);
+        alg_regs.reg_dpc_enable = drawRegister(gen, "reg_dpc_enable", 0, 1) != 0;
+        alg_regs.reg_dpc_threshold = (int)drawRegister(gen, "reg_dpc_threshold", 0, 65535);
+        legalizeCrop(alg_regs);
+
+        input_image.resize((size_t)alg_regs.reg_image_width * alg_regs.reg_image_height);
+        for (size_t i = 0; i < input_image.size(); i++) {
+            input_image[i] = static_cast<T>(gen() >> (64 - W));
+        }
+    }
+
+    // true when alg and hls agree on the final output and the framing
+    static bool check(alg_top_t& alg_top, hls_top_t& hls_top, const AlgRegisterSection& alg_regs, const frame_vector<T>& input_image) {
+        alg_top.alg_register_section = alg_regs;
+        hls_top.hls_register_section = toHlsRegisterSection(alg_regs);
+        alg_top.process(input_image);
+        hls_top.process(input_image);
+        if (!hls_top.hls_framing_ok || alg_top.alg_crop_output_image.size() != hls_top.hls_output_image.size()) {
+            return false;
+        }
+        return equal(alg_top.alg_crop_output_image.begin(), alg_top.alg_crop_output_image.end(), hls_top.hls_output_image.begin(),
+                     [](T a, T b) { return a == b; });
+    }
+
+
+    // case_num cases of campaign seed on thread_num workers (0: hardware concurrency)
+    void run(uint64_t case_num, uint64_t seed, int thread_num) {
+        if (thread_num <= 0) {
+            thread_num = max(1, (int)thread::hardware_concurrency());
+        }
+        MAIN_INFO_1(to_string(W) + " bit fuzz run, case num: " + to_string(case_num) + ", thread num: " + to_string(thread_num));
+
+        fail_list.clear();
+        atomic<uint64_t> next_case(0);
+        atomic<uint64_t> run_num(0);
+        atomic<bool> stop(false);
+        mutex fail_mutex;
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        vector<thread> worker_list;
+        for (int t = 0; t < thread_num; t++) {
+            worker_list.push_back(thread([&]() {
+                alg_top_t alg_top;
+                alg_top.alg_stage_cache_enable = false;
+                alg_top.alg_dpc_stage_enable = true;
+                hls_top_t hls_top;
+                hls_top.hls_dpc_stage_enable = true;
+                AlgRegisterSection alg_regs;
+                frame_vector<T> input_image;
+                uint64_t local_run = 0;
+                for (uint64_t i = next_case++; i < case_num && !stop; i = next_case++) {
+                    uint64_t case_seed = random_seed(seed, i);
+                    generate(case_seed, alg_regs, input_image);
+                    local_run++;
+                    if (check(alg_top, hls_top, alg_regs, input_image)) {
+                        continue;
+                    }
+                    lock_guard<mutex> lock(fail_mutex);
+                    CrossCheckFuzzFail fail;
+                    fail.case_index = i;
+                    fail.case_seed = case_seed;
+                    fail_list.push_back(fail);
+                    if ((int)fail_list.size() >= max_fail) {
+                        stop = true;
+                    }
+                }
+                run_num += local_run;
+            }));
+        }
+        for (size_t t = 0; t < worker_list.size(); t++) {
+            worker_list[t].join();
+        }
+        double second = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        case_run = run_num;
+        sort(fail_list.begin(), fail_list.end(), [](const CrossCheckFuzzFail& a, const CrossCheckFuzzFail& b) { return a.case_index < b.case_index; });
+
+        char line[256];
+        snprintf(line, sizeof(line), "%d bit: %llu/%llu cases passed in %.2f s, %.0f cases/s",
+                 W, (unsigned long long)(case_run - fail_list.size()), (unsigned long long)case_run, second,
+                 second > 0 ? case_run / second : 0.0);
+        main_info(CROSS_CHECK_FUZZ_SECTION, line);
+    }
+
+
+    // shrinks a failing case while it keeps failing, returns the number of model runs used
+    int minimize(AlgRegisterSection& alg_regs, frame_vector<T>& input_image) const {
+        alg_top_t alg_top;
+        alg_top.alg_stage_cache_enable = false;
+        alg_top.alg_dpc_stage_enable = true;
+        hls_top_t hls_top;
+        hls_top.hls_dpc_stage_enable = true;
+        int try_num = 0;
+        auto fails = [&](const AlgRegisterSection& regs, const frame_vector<T>& image) {
+            try_num++;
+            return !check(alg_top, hls_top, regs, image);
+        };
+
+        bool changed = true;
+        while (changed && try_num < CROSS_CHECK_FUZZ_MINIMIZE_TRY_NUM) {
+            changed = false;
+
+            // smaller sub-frames: halves first, then single rows / columns from every side
+            int width = alg_regs.reg_image_width;
+            int height = alg_regs.reg_image_height;
+            int window[][4] = {
+                {0, 0, width, (height + 1) / 2}, {0, height / 2, width, height - height / 2},
+                {0, 0, (width + 1) / 2, height}, {width / 2, 0, width - width / 2, height},
+                {0, 0, width, height - 1}, {0, 1, width, height - 1},
+                {0, 0, width - 1, height}, {1, 0, width - 1, height},
+            };
+            for (size_t k = 0; k < sizeof(window) / sizeof(window[0]) && !changed; k++) {
+                int w = window[k][2];
+                int h = window[k][3];
+                if (w < 1 || h < 1 || (w == width && h == height)) {
+                    continue;
+                }
+                AlgRegisterSection sub_regs;
+                frame_vector<T> sub_image;
+                subFrame(alg_regs, input_image, window[k][0], window[k][1], w, h, sub_regs, sub_image);
+                if (fails(sub_regs, sub_image)) {
+                    alg_regs = sub_regs;
+                    input_image.swap(sub_image);
+                    changed = true;
+                }
+            }
+            if (changed) {
+                continue;
+            }
+
+            // stages off, lower threshold
+            AlgRegisterSection reg_try[3] = {alg_regs, alg_regs, alg_regs};
+            reg_try[0].reg_crop_enable = false;
+            reg_try[1].reg_dpc_enable = false;
+            reg_try[2].reg_dpc_threshold = alg_regs.reg_dpc_threshold / 2;
+            for (int k = 0; k < 3 && !changed; k++) {
+                if (registerDiffer(reg_try[k], alg_regs) && fails(reg_try[k], input_image)) {
+                    alg_regs = reg_try[k];
+                    changed = true;
+                }
+            }
+            if (changed) {
+                continue;
+            }
+
+            // zero pixel blocks, halving block size
+            for (size_t block = max<size_t>(1, input_image.size() / 2); block >= 1 && !changed; block /= 2) {
+                for (size_t start = 0; start < input_image.size() && try_num < CROSS_CHECK_FUZZ_MINIMIZE_TRY_NUM; start += block) {
+                    size_t end = min(input_image.size(), start + block);
+                    if (all_of(input_image.begin() + start, input_image.begin() + end, [](T v) { return v == 0; })) {
+                        continue;
+                    }
+                    frame_vector<T> zero_image = input_image;
+                    fill(zero_image.begin() + start, zero_image.begin() + end, T(0));
+                    if (fails(alg_regs, zero_image)) {
+                        input_image.swap(zero_image);
+                        changed = true;
+                    }
+                }
+                if (block == 1) {
+                    break;
+                }
+            }
+        }
+        return try_num;
+    }
+
+
+    // minimizes and prints every collected failure, stage by stage
+    void report(size_t max_report) const {
+        for (size_t f = 0; f < fail_list.size(); f++) {
+            const CrossCheckFuzzFail& fail = fail_list[f];
+            AlgRegisterSection alg_regs;
+            frame_vector<T> input_image;
+            generate(fail.case_seed, alg_regs, input_image);
+            char line[256];
+            snprintf(line, sizeof(line), "%d bit case %llu FAIL (replay --bitwidth %d --replay 0x%016llx): %s",
+                     W, (unsigned long long)fail.case_index, W, (unsigned long long)fail.case_seed, registerString(alg_regs).c_str());
+            main_info(CROSS_CHECK_FUZZ_SECTION, line);
+
+            int try_num = minimize(alg_regs, input_image);
+            main_info(CROSS_CHECK_FUZZ_SECTION, "  minimized in " + to_string(try_num) + " runs: " + registerString(alg_regs));
+            printCase(alg_regs, input_image, max_report);
+
+            if (!fail_dir.empty()) {
+                string path = fail_dir + "/fuzz_fail_" + to_string(W) + "bit_" + to_string(fail.case_index) + ".txt";
+                vector_write_to_file(path, input_image, alg_regs.reg_image_width, alg_regs.reg_image_height);
+                main_info(CROSS_CHECK_FUZZ_SECTION, "  minimized input save to: " + path);
+            }
+        }
+    }
+
+    // one case, both stages compared, used by report() and replay
+    void printCase(const AlgRegisterSection& alg_regs, const frame_vector<T>& input_image, size_t max_report) const {
+        alg_top_t alg_top;
+        alg_top.alg_stage_cache_enable = false;
+        alg_top.alg_dpc_stage_enable = true;
+        hls_top_t hls_top;
+        hls_top.hls_dpc_stage_enable = true;
+        hls_top.hls_stage_output_enable = true;
+        check(alg_top, hls_top, alg_regs, input_image);
+        if (input_image.size() <= 64) {
+            string pixel;
+            for (size_t i = 0; i < input_image.size(); i++) {
+                pixel += (i > 0 && i % alg_regs.reg_image_width == 0 ? " | " : " ") + to_string((int)input_image[i]);
+            }
+            main_info(CROSS_CHECK_FUZZ_SECTION, "  input:" + pixel);
+        }
+        cross_check_print(CROSS_CHECK_FUZZ_SECTION, cross_check_image("dpc", alg_top.alg_dpc_output_image, hls_top.hls_dpc_output_image,
+                                                                      alg_regs.reg_image_width, alg_regs.reg_image_height, max_report));
+        cross_check_print(CROSS_CHECK_FUZZ_SECTION, cross_check_image("crop", alg_top.alg_crop_output_image, hls_top.hls_output_image,
+                                                                      alg_top.getOutputWidth(), alg_top.getOutputHeight(), max_report));
+        if (!hls_top.hls_framing_ok) {
+            main_info(CROSS_CHECK_FUZZ_SECTION, "  hls output framing (SOF/EOL/keep) does not match the frame size");
+        }
+    }
+
+    static string registerString(const AlgRegisterSection& alg_regs) {
+        return to_string(alg_regs.reg_image_width) + "x" + to_string(alg_regs.reg_image_height)
+               + " crop=" + to_string(alg_regs.reg_crop_enable)
+               + " x=[" + to_string(alg_regs.reg_crop_start_x) + "," + to_string(alg_regs.reg_crop_end_x) + "]"
+               + " y=[" + to_string(alg_regs.reg_crop_start_y) + "," + to_string(alg_regs.reg_crop_end_y) + "]"
+               + " dpc=" + to_string(alg_regs.reg_dpc_enable) + " threshold=" + to_string(alg_regs.reg_dpc_threshold);
+    }
+
+    static HlsRegisterSection toHlsRegisterSection(const AlgRegisterSection& alg_regs) {
+        HlsRegisterSection hls_regs;
+        hls_regs.reg_image_width = alg_regs.reg_image_width;
+        hls_regs.reg_image_height = alg_regs.reg_image_height;
+        hls_regs.reg_crop_enable = alg_regs.reg_crop_enable;
+        hls_regs.reg_crop_start_x = alg_regs.reg_crop_start_x;
+        hls_regs.reg_crop_start_y = alg_regs.reg_crop_start_y;
+        hls_regs.reg_crop_end_x = alg_regs.reg_crop_end_x;
+        hls_regs.reg_crop_end_y = alg_regs.reg_crop_end_y;
+        hls_regs.reg_dpc_enable = alg_regs.reg_dpc_enable;
+        hls_regs.reg_dpc_threshold = alg_regs.reg_dpc_threshold;
+        return hls_regs;
+    }
+
+
+private:
+    // [cons_min, cons_max] of the register table intersected with [lo, hi]
+    int64_t drawRegister(Xoshiro256ss& gen, const string& reg_name, int64_t lo, int64_t hi) const {
+        map<string, RegisterInfo>::const_iterator it = register_section.reg_map.find(reg_name);
+        if (it != register_section.reg_map.end()) {
+            lo = max<int64_t>(lo, it->second.reg_value_min);
+            hi = min<int64_t>(hi, it->second.reg_value_max);
+        }
+        return (hi < lo) ? lo : gen.uniform(lo, hi);
+    }
+
+    // start clamped into the frame, end into [start, size - 1]
+    static void legalizeCrop(AlgRegisterSection& alg_regs) {
+        alg_regs.reg_crop_start_x = min(alg_regs.reg_crop_start_x, alg_regs.reg_image_width - 1);
+        alg_regs.reg_crop_start_y = min(alg_regs.reg_crop_start_y, alg_regs.reg_image_height - 1);
+        alg_regs.reg_crop_end_x = max(alg_regs.reg_crop_start_x, min(alg_regs.reg_crop_end_x, alg_regs.reg_image_width - 1));
+        alg_regs.reg_crop_end_y = max(alg_regs.reg_crop_start_y, min(alg_regs.reg_crop_end_y, alg_regs.reg_image_height - 1));
+    }
+
+    // w x h window at (x0, y0), crop window moved along and clamped into it
+    static void subFrame(const AlgRegisterSection& alg_regs, const frame_vector<T>& input_image, int x0, int y0, int w, int h,
+                         AlgRegisterSection& sub_regs, frame_vector<T>& sub_image) {
+        sub_regs = alg_regs;
+        sub_regs.reg_image_width = w;
+        sub_regs.reg_image_height = h;
+        sub_regs.reg_crop_start_x = max(0, alg_regs.reg_crop_start_x - x0);
+        sub_regs.reg_crop_start_y = max(0, alg_regs.reg_crop_start_y - y0);
+        sub_regs.reg_crop_end_x = max(0, alg_regs.reg_crop_end_x - x0);
+        sub_regs.reg_crop_end_y = max(0, alg_regs.reg_crop_end_y - y0);
+        legalizeCrop(sub_regs);
+        sub_image.resize((size_t)w * h);
+        for (int y = 0; y < h; y++) {
+            copy(input_image.begin() + (size_t)(y0 + y) * alg_regs.reg_image_width + x0,
+                 input_image.begin() + (size_t)(y0 + y) * alg_regs.reg_image_width + x0 + w,
+                 sub_image.begin() + (size_t)y * w);
+        }
+    }
+
+    static bool registerDiffer(const AlgRegisterSection& a, const AlgRegisterSection& b) {
+        return registerString(a) != registerString(b);
+    }
+};
+
+
+#endif // CROSS_CHECK_FUZZ_H
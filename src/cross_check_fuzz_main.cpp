@@ -0,0 +1,138 @@
+// std
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+#include "random_function.h"
+#include "cross_check_function.h"
+
+// ip
+#include "cross_check_fuzz.h"
+
+// def
+#define CROSS_CHECK_FUZZ_MAIN_SECTION       "cross_check_fuzz_main"
+#define CROSS_CHECK_FUZZ_REGISTER_TABLE     "./config/register_table.csv"
+#define CROSS_CHECK_FUZZ_MAIN_USAGE         "usage: cross_check_fuzz_main [case_num] [seed] [--register-table path] " \
+                                            "[--bitwidth 8|10|12|16] [--threads N] [--max-width N] [--max-height N] " \
+                                            "[--max-fail N] [--max-report N] [--fail-dir dir] [--replay case_seed]"
+
+// using
+using namespace std;
+
+
+struct CrossCheckFuzzOption {
+    uint64_t case_num = 100000;
+    uint64_t seed = 1;
+    string register_table_path = CROSS_CHECK_FUZZ_REGISTER_TABLE;
+    int bitwidth = 0;                       // 0: 8, 10, 12 and 16 bit
+    int thread_num = 0;                     // 0: hardware concurrency
+    int max_width = CROSS_CHECK_FUZZ_MAX_WIDTH;
+    int max_height = CROSS_CHECK_FUZZ_MAX_HEIGHT;
+    int max_fail = CROSS_CHECK_FUZZ_MAX_FAIL;
+    size_t max_report = CROSS_CHECK_MAX_REPORT;
+    string fail_dir;
+    bool replay_enable = false;
+    uint64_t replay_seed = 0;
+};
+
+
+template <typename T, int W>
+int run_fuzz(const CrossCheckFuzzOption& option, const RegisterSection& register_section) {
+    CrossCheckFuzz<T, W> fuzz;
+    fuzz.register_section = register_section;
+    fuzz.max_width = option.max_width;
+    fuzz.max_height = option.max_height;
+    fuzz.max_fail = option.max_fail;
+    fuzz.fail_dir = option.fail_dir;
+
+    // one case from its seed, as printed for a failure
+    if (option.replay_enable) {
+        AlgRegisterSection alg_regs;
+        frame_vector<T> input_image;
+        fuzz.generate(option.replay_seed, alg_regs, input_image);
+        MAIN_INFO_1(to_string(W) + " bit replay: " + fuzz.registerString(alg_regs));
+        fuzz.printCase(alg_regs, input_image, option.max_report);
+        return 0;
+    }
+
+    fuzz.run(option.case_num, option.seed, option.thread_num);
+    fuzz.report(option.max_report);
+    return (int)fuzz.fail_list.size();
+}
+
+
+// usage: cross_check_fuzz_main [case_num] [seed] [--register-table path] [--bitwidth 8|10|12|16] [--threads N]
+//                              [--max-width N] [--max-height N] [--max-fail N] [--max-report N] [--fail-dir dir]
+//                              [--replay case_seed]
+int main(const int argc, const char *argv[]) {
+    CrossCheckFuzzOption option;
+    const string usage = CROSS_CHECK_FUZZ_MAIN_USAGE;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--register-table" && i + 1 < argc) {
+            option.register_table_path = argv[++i];
+        } else if (arg == "--bitwidth" && i + 1 < argc) {
+            option.bitwidth = (int)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 8, 16);
+            if (option.bitwidth != 8 && option.bitwidth != 10 && option.bitwidth != 12 && option.bitwidth != 16) {
+                cross_check_arg_error(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, "--bitwidth must be 8, 10, 12 or 16");
+            }
+        } else if (arg == "--threads" && i + 1 < argc) {
+            option.thread_num = (int)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 0, 1024);
+        } else if (arg == "--max-width" && i + 1 < argc) {
+            option.max_width = (int)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 1, HLS_DPC_MAX_WIDTH);
+        } else if (arg == "--max-height" && i + 1 < argc) {
+            option.max_height = (int)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 1, 65535);
+        } else if (arg == "--max-fail" && i + 1 < argc) {
+            option.max_fail = (int)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 1, 1000000);
+        } else if (arg == "--max-report" && i + 1 < argc) {
+            option.max_report = (size_t)cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 0, 1000000);
+        } else if (arg == "--fail-dir" && i + 1 < argc) {
+            option.fail_dir = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            option.replay_enable = true;
+            option.replay_seed = cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, arg, argv[++i], 0, UINT64_MAX);
+        } else if (positional == 0 && isdigit((unsigned char)arg[0])) {
+            option.case_num = cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, "case_num", arg, 1, UINT64_MAX);
+            positional++;
+        } else if (positional == 1 && isdigit((unsigned char)arg[0])) {
+            option.seed = cross_check_arg_number(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, "seed", arg, 0, UINT64_MAX);
+            positional++;
+        } else {
+            cross_check_arg_error(CROSS_CHECK_FUZZ_MAIN_SECTION, usage, "unknown argument or missing value: " + arg);
+        }
+    }
+    if (option.max_width < 1 || option.max_width > HLS_DPC_MAX_WIDTH || option.max_height < 1) {
+        MAIN_ERROR_1("frame size out of range, width 1.." + to_string(HLS_DPC_MAX_WIDTH) + ", height >= 1");
+    }
+
+    MAIN_INFO_1("register table: " + option.register_table_path);
+    RegisterSection register_section = LoadCSVFile(option.register_table_path);
+    MAIN_INFO_1("case num: " + to_string(option.case_num) + ", seed: " + to_string(option.seed)
+                + ", max size: " + to_string(option.max_width) + "x" + to_string(option.max_height));
+
+    int fail_num = 0;
+    if (option.bitwidth == 0 || option.bitwidth == 8) {
+        fail_num += run_fuzz<uint8_t, 8>(option, register_section);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 10) {
+        fail_num += run_fuzz<uint16_t, 10>(option, register_section);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 12) {
+        fail_num += run_fuzz<uint16_t, 12>(option, register_section);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 16) {
+        fail_num += run_fuzz<uint16_t, 16>(option, register_section);
+    }
+
+    if (fail_num > 0) {
+        MAIN_ERROR_1(to_string(fail_num) + " cases failed");
+    }
+    MAIN_INFO_1("all cases passed");
+    return 0;
+}
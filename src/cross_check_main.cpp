@@ -0,0 +1,193 @@
+// std
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+#include "cross_check_function.h"
+
+// ip
+#include "alg_top.h"
+#include "hls_top.h"
+
+// def
+#define CROSS_CHECK_MAIN_SECTION    "cross_check_main"
+#define CROSS_CHECK_MAX_WIDTH       256
+#define CROSS_CHECK_MAX_HEIGHT      64
+#define CROSS_CHECK_MAIN_USAGE      "usage: cross_check_main [case_num] [seed] [--bitwidth 8|10|12|16] [--max-width N] " \
+                                    "[--max-height N] [--max-report N] [--stop-on-fail]"
+
+// using
+using namespace std;
+
+
+struct CrossCheckOption {
+    int case_num = 1000;
+    unsigned seed = 1;
+    int bitwidth = 0;                       // 0: 8, 10, 12 and 16 bit
+    int max_width = CROSS_CHECK_MAX_WIDTH;
+    int max_height = CROSS_CHECK_MAX_HEIGHT;
+    size_t max_report = CROSS_CHECK_MAX_REPORT;
+    bool stop_on_fail = false;
+};
+
+
+// random frame size, crop window, enables and threshold, the same values go to both register sections
+static void random_register_section(mt19937& gen, const CrossCheckOption& option, int case_index, int bitwidth,
+                                    AlgRegisterSection& alg_regs, HlsRegisterSection& hls_regs) {
+    alg_regs.reg_image_width = uniform_int_distribution<int>(1, option.max_width)(gen);
+    alg_regs.reg_image_height = uniform_int_distribution<int>(1, option.max_height)(gen);
+    alg_regs.reg_crop_enable = (case_index % 4) != 1;
+    alg_regs.reg_crop_start_x = uniform_int_distribution<int>(0, alg_regs.reg_image_width - 1)(gen);
+    alg_regs.reg_crop_end_x = uniform_int_distribution<int>(alg_regs.reg_crop_start_x, alg_regs.reg_image_width - 1)(gen);
+    alg_regs.reg_crop_start_y = uniform_int_distribution<int>(0, alg_regs.reg_image_height - 1)(gen);
+    alg_regs.reg_crop_end_y = uniform_int_distribution<int>(alg_regs.reg_crop_start_y, alg_regs.reg_image_height - 1)(gen);
+    alg_regs.reg_dpc_enable = (case_index % 4) != 2;
+    alg_regs.reg_dpc_threshold = uniform_int_distribution<int>(0, (1 << (bitwidth < 16 ? bitwidth : 15)) / 4)(gen);
+
+    hls_regs.reg_image_width = alg_regs.reg_image_width;
+    hls_regs.reg_image_height = alg_regs.reg_image_height;
+    hls_regs.reg_crop_enable = alg_regs.reg_crop_enable;
+    hls_regs.reg_crop_start_x = alg_regs.reg_crop_start_x;
+    hls_regs.reg_crop_start_y = alg_regs.reg_crop_start_y;
+    hls_regs.reg_crop_end_x = alg_regs.reg_crop_end_x;
+    hls_regs.reg_crop_end_y = alg_regs.reg_crop_end_y;
+    hls_regs.reg_dpc_enable = alg_regs.reg_dpc_enable;
+    hls_regs.reg_dpc_threshold = alg_regs.reg_dpc_threshold;
+}
+
+
+static string register_string(const AlgRegisterSection& alg_regs) {
+    return to_string(alg_regs.reg_image_width) + "x" + to_string(alg_regs.reg_image_height)
+           + " crop=" + to_string(alg_regs.reg_crop_enable)
+           + " x=[" + to_string(alg_regs.reg_crop_start_x) + "," + to_string(alg_regs.reg_crop_end_x) + "]"
+           + " y=[" + to_string(alg_regs.reg_crop_start_y) + "," + to_string(alg_regs.reg_crop_end_y) + "]"
+           + " dpc=" + to_string(alg_regs.reg_dpc_enable) + " threshold=" + to_string(alg_regs.reg_dpc_threshold);
+}
+
+
+// AlgTop vs HlsTop on the same input and registers, every stage compared in memory
+template <typename T, int W>
+int run_cross_check(const CrossCheckOption& option) {
+    mt19937 gen(option.seed);
+    AlgTop<T, T> alg_top;
+    alg_top.alg_stage_cache_enable = false;     // every case is a new input
+    alg_top.alg_dpc_stage_enable = true;        // same dpc -> crop order as the hls pipeline
+    HlsTop<T, T, W, W, HLS_AXIS_PACK_PPC(W)> hls_top;
+    hls_top.hls_dpc_stage_enable = true;
+    hls_top.hls_stage_output_enable = true;
+    frame_vector<T> input_image;
+    uniform_int_distribution<int> pixel_distrib(0, (1 << W) - 1);
+
+    int case_run = 0;
+    int fail_num = 0;
+    double alg_us = 0;
+    double hls_us = 0;
+    for (int case_index = 0; case_index < option.case_num; case_index++) {
+        random_register_section(gen, option, case_index, W, alg_top.alg_register_section, hls_top.hls_register_section);
+        const AlgRegisterSection& alg_regs = alg_top.alg_register_section;
+        input_image.resize((size_t)alg_regs.reg_image_width * alg_regs.reg_image_height);
+        for (size_t i = 0; i < input_image.size(); i++) {
+            input_image[i] = pixel_distrib(gen);
+        }
+        case_run++;
+
+        chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+        alg_top.process(input_image);
+        chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+        hls_top.process(input_image);
+        chrono::steady_clock::time_point t2 = chrono::steady_clock::now();
+        alg_us += chrono::duration<double, micro>(t1 - t0).count();
+        hls_us += chrono::duration<double, micro>(t2 - t1).count();
+
+        CrossCheckResult dpc_result = cross_check_image("dpc", alg_top.alg_dpc_output_image, hls_top.hls_dpc_output_image,
+                                                        alg_regs.reg_image_width, alg_regs.reg_image_height, option.max_report);
+        CrossCheckResult crop_result = cross_check_image("crop", alg_top.alg_crop_output_image, hls_top.hls_output_image,
+                                                         alg_top.getOutputWidth(), alg_top.getOutputHeight(), option.max_report);
+        if (dpc_result.pass() && crop_result.pass() && hls_top.hls_framing_ok) {
+            continue;
+        }
+
+        fail_num++;
+        MAIN_INFO_1(to_string(W) + " bit case " + to_string(case_index) + " FAIL: " + register_string(alg_regs));
+        cross_check_print(CROSS_CHECK_MAIN_SECTION, dpc_result);
+        cross_check_print(CROSS_CHECK_MAIN_SECTION, crop_result);   // crop coordinates are inside the crop window
+        if (!hls_top.hls_framing_ok) {
+            MAIN_INFO_1("  hls output framing (SOF/EOL/keep) does not match the frame size");
+        }
+        if (option.stop_on_fail) {
+            break;
+        }
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "%d bit: %d/%d cases passed, alg %.1f us/case, hls %.1f us/case",
+             W, case_run - fail_num, case_run, case_run ? alg_us / case_run : 0.0, case_run ? hls_us / case_run : 0.0);
+    main_info(CROSS_CHECK_MAIN_SECTION, line);
+    return fail_num;
+}
+
+
+// usage: cross_check_main [case_num] [seed] [--bitwidth 8|10|12|16] [--max-width N] [--max-height N]
+//                         [--max-report N] [--stop-on-fail]
+int main(const int argc, const char *argv[]) {
+    CrossCheckOption option;
+    const string usage = CROSS_CHECK_MAIN_USAGE;
+    int positional = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--bitwidth" && i + 1 < argc) {
+            option.bitwidth = (int)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, arg, argv[++i], 8, 16);
+            if (option.bitwidth != 8 && option.bitwidth != 10 && option.bitwidth != 12 && option.bitwidth != 16) {
+                cross_check_arg_error(CROSS_CHECK_MAIN_SECTION, usage, "--bitwidth must be 8, 10, 12 or 16");
+            }
+        } else if (arg == "--max-width" && i + 1 < argc) {
+            option.max_width = (int)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, arg, argv[++i], 1, HLS_DPC_MAX_WIDTH);
+        } else if (arg == "--max-height" && i + 1 < argc) {
+            option.max_height = (int)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, arg, argv[++i], 1, 65535);
+        } else if (arg == "--max-report" && i + 1 < argc) {
+            option.max_report = (size_t)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, arg, argv[++i], 0, 1000000);
+        } else if (arg == "--stop-on-fail") {
+            option.stop_on_fail = true;
+        } else if (positional == 0 && isdigit((unsigned char)arg[0])) {
+            option.case_num = (int)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, "case_num", arg, 1, INT32_MAX);
+            positional++;
+        } else if (positional == 1 && isdigit((unsigned char)arg[0])) {
+            option.seed = (unsigned)cross_check_arg_number(CROSS_CHECK_MAIN_SECTION, usage, "seed", arg, 0, UINT32_MAX);
+            positional++;
+        } else {
+            cross_check_arg_error(CROSS_CHECK_MAIN_SECTION, usage, "unknown argument or missing value: " + arg);
+        }
+    }
+    if (option.max_width < 1 || option.max_width > HLS_DPC_MAX_WIDTH || option.max_height < 1) {
+        MAIN_ERROR_1("frame size out of range, width 1.." + to_string(HLS_DPC_MAX_WIDTH) + ", height >= 1");
+    }
+    MAIN_INFO_1("case num: " + to_string(option.case_num) + ", seed: " + to_string(option.seed)
+                + ", max size: " + to_string(option.max_width) + "x" + to_string(option.max_height));
+
+    int fail_num = 0;
+    if (option.bitwidth == 0 || option.bitwidth == 8) {
+        fail_num += run_cross_check<uint8_t, 8>(option);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 10) {
+        fail_num += run_cross_check<uint16_t, 10>(option);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 12) {
+        fail_num += run_cross_check<uint16_t, 12>(option);
+    }
+    if (option.bitwidth == 0 || option.bitwidth == 16) {
+        fail_num += run_cross_check<uint16_t, 16>(option);
+    }
+
+    if (fail_num > 0) {
+        MAIN_ERROR_1(to_string(fail_num) + " cases failed");
+    }
+    MAIN_INFO_1("all cases passed");
+    return 0;
+}
@@ -0,0 +1,168 @@
+#ifndef FRAME_BUFFER_POOL_H
+#define FRAME_BUFFER_POOL_H
+
+// std
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <string>
+
+// tool
+#include "print_function.h"
+
+// def
+#define FRAME_BUFFER_POOL_SECTION       "FrameBufferPool"
+#define FRAME_BUFFER_POOL_ALIGNMENT     64
+#define FRAME_BUFFER_POOL_PAGE_SIZE     4096
+#define FRAME_BUFFER_POOL_MIN_BYTES     (size_t(1) << 12)   // 4 KiB
+#define FRAME_BUFFER_POOL_STEP_BYTES    (size_t(1) << 20)   // 1 MiB
+
+// using
+using namespace std;
+
+
+struct FrameBufferPoolStats {
+    size_t hits;            // checkout served from a free list
+    size_t misses;          // checkout that had to map fresh memory
+    size_t releases;        // buffers returned to the pool
+    size_t in_use_bytes;    // bytes currently checked out
+    size_t peak_bytes;      // max bytes checked out at the same time
+    size_t pool_bytes;      // bytes owned by the pool (in use + cached)
+};
+
+
+// size-classed pool of 64-byte aligned frame buffers
+//  - below 1 MiB the classes are powers of two from 4 KiB (line buffers, growing stream storage)
+//  - from 1 MiB up a buffer is rounded up to the next whole MiB, a 4K 16-bit frame (~16.6 MB)
+//    takes a 17 MiB block instead of a 32 MiB one
+// buffers are never given back to the system before exit, so a multi-frame run
+// reaches a steady state where every checkout is a hit on an already faulted-in block
+// the pool itself is never destroyed either: frame_vector objects with static or thread_local
+// storage may still release into it while the program exits
+class FrameBufferPool {
+public:
+    static FrameBufferPool& instance() {
+        static FrameBufferPool* pool = new FrameBufferPool();
+        return *pool;
+    }
+
+    void* acquire(size_t bytes) {
+        size_t class_bytes = get_class_bytes(bytes);
+        void* ptr = nullptr;
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            vector<void*>& free_list = pool_free_list[class_bytes];
+            if (!free_list.empty()) {
+                ptr = free_list.back();
+                free_list.pop_back();
+                pool_stats.hits++;
+            } else {
+                pool_stats.misses++;
+                pool_stats.pool_bytes += class_bytes;
+            }
+            pool_stats.in_use_bytes += class_bytes;
+            if (pool_stats.in_use_bytes > pool_stats.peak_bytes) {
+                pool_stats.peak_bytes = pool_stats.in_use_bytes;
+            }
+        }
+        if (ptr == nullptr) {
+            // 新申请的内存在这里一次性触发缺页，之后复用时不再有缺页
+            if (posix_memalign(&ptr, FRAME_BUFFER_POOL_ALIGNMENT, class_bytes) != 0) {
+                throw bad_alloc();
+            }
+            for (size_t i = 0; i < class_bytes; i += FRAME_BUFFER_POOL_PAGE_SIZE) {
+                static_cast<volatile char*>(ptr)[i] = 0;
+            }
+        }
+        return ptr;
+    }
+
+    void release(void* ptr, size_t bytes) {
+        if (ptr == nullptr) {
+            return;
+        }
+        size_t class_bytes = get_class_bytes(bytes);
+        lock_guard<mutex> lock(pool_mutex);
+        pool_free_list[class_bytes].push_back(ptr);
+        pool_stats.releases++;
+        pool_stats.in_use_bytes -= class_bytes;
+    }
+
+    FrameBufferPoolStats stats() const {
+        lock_guard<mutex> lock(pool_mutex);
+        return pool_stats;
+    }
+
+    // called by the mains once a run is done, the pool has no destructor to do it
+    void print_stats() const {
+        FrameBufferPoolStats s = stats();
+        main_info(FRAME_BUFFER_POOL_SECTION, "hits: " + to_string(s.hits)
+                  + ", misses: " + to_string(s.misses)
+                  + ", releases: " + to_string(s.releases));
+        main_info(FRAME_BUFFER_POOL_SECTION, "peak bytes: " + to_string(s.peak_bytes)
+                  + ", pool bytes: " + to_string(s.pool_bytes)
+                  + ", in use bytes: " + to_string(s.in_use_bytes));
+    }
+
+private:
+    FrameBufferPool() {
+        memset(&pool_stats, 0, sizeof(pool_stats));
+    }
+
+    FrameBufferPool(const FrameBufferPool&);
+    FrameBufferPool& operator=(const FrameBufferPool&);
+
+    static size_t get_class_bytes(size_t bytes) {
+        if (bytes >= FRAME_BUFFER_POOL_STEP_BYTES) {
+            if (bytes > SIZE_MAX - FRAME_BUFFER_POOL_STEP_BYTES) {
+                throw bad_alloc();
+            }
+            return (bytes + FRAME_BUFFER_POOL_STEP_BYTES - 1) / FRAME_BUFFER_POOL_STEP_BYTES * FRAME_BUFFER_POOL_STEP_BYTES;
+        }
+        size_t class_bytes = FRAME_BUFFER_POOL_MIN_BYTES;
+        while (class_bytes < bytes) {
+            class_bytes <<= 1;
+        }
+        return class_bytes;
+    }
+
+    mutable mutex pool_mutex;
+    map<size_t, vector<void*>> pool_free_list;      // class bytes -> free blocks
+    FrameBufferPoolStats pool_stats;
+};
+
+
+// std::vector allocator checking storage out of / back into the FrameBufferPool
+template <typename T>
+struct FramePoolAllocator {
+    typedef T value_type;
+
+    FramePoolAllocator() {}
+    template <typename U>
+    FramePoolAllocator(const FramePoolAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(FrameBufferPool::instance().acquire(n * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t n) {
+        FrameBufferPool::instance().release(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const FramePoolAllocator<T>&, const FramePoolAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const FramePoolAllocator<T>&, const FramePoolAllocator<U>&) { return false; }
+
+// image buffer type used for all intermediate frames
+template <typename T>
+using frame_vector = vector<T, FramePoolAllocator<T>>;
+
+
+#endif // FRAME_BUFFER_POOL_H
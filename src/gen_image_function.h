@@ -0,0 +1,97 @@
+#ifndef GEN_IMAGE_FUNCTION_H
+#define GEN_IMAGE_FUNCTION_H
+
+// deterministic random frames for fuzzing / stress runs
+//  - the frame is cut into GEN_IMAGE_TILE_SIZE x GEN_IMAGE_TILE_SIZE tiles, tile i of frame f is
+//    filled from its own generator seeded with random_seed(frame seed, i), so the image only depends
+//    on (seed, width, height, bitwidth), never on the thread count or the tile order
+//  - a tile generator is Xoshiro256ssLanes<GEN_IMAGE_LANES>: every step gives GEN_IMAGE_LANES 64-bit
+//    words, each word is 4 samples of 16 bits masked to the bit width (uniform, the range is a power
+//    of two), both loops vectorize
+//  - tiles are spread over thread_num workers
+
+// std
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+// tool
+#include "random_function.h"
+
+// def
+#define GEN_IMAGE_FUNCTION_SECTION  "[gen_image_function]"
+#define GEN_IMAGE_TILE_SIZE         64
+#define GEN_IMAGE_LANES             8
+#define GEN_IMAGE_STEP_SAMPLES      (GEN_IMAGE_LANES * 4)
+
+// using
+using namespace std;
+
+
+// samples [0, n) of one tile row from gen, masked to mask
+template <typename T>
+void gen_image_fill_row(Xoshiro256ssLanes<GEN_IMAGE_LANES>& gen, T* row, int n, uint16_t mask) {
+    uint64_t word[GEN_IMAGE_LANES];
+    int x = 0;
+    for (; x + GEN_IMAGE_STEP_SAMPLES <= n; x += GEN_IMAGE_STEP_SAMPLES) {
+        gen.next(word);
+        for (int k = 0; k < GEN_IMAGE_STEP_SAMPLES; k++) {
+            row[x + k] = (T)((uint16_t)(word[k >> 2] >> (16 * (k & 3))) & mask);
+        }
+    }
+    if (x < n) {
+        gen.next(word);
+        for (int k = 0; x + k < n; k++) {
+            row[x + k] = (T)((uint16_t)(word[k >> 2] >> (16 * (k & 3))) & mask);
+        }
+    }
+}
+
+// width x height frame of bitwidth-bit uniform samples, deterministic in seed
+template <typename T, typename ALLOC>
+void gen_image_random(vector<T, ALLOC>& image, int width, int height, int bitwidth, uint64_t seed, int thread_num = 0) {
+    image.resize((size_t)width * height);
+    if (image.empty()) {
+        return;
+    }
+    uint16_t mask = (uint16_t)((bitwidth >= 16) ? 0xffff : ((1u << max(1, bitwidth)) - 1));
+    int tile_x_num = (width + GEN_IMAGE_TILE_SIZE - 1) / GEN_IMAGE_TILE_SIZE;
+    int tile_y_num = (height + GEN_IMAGE_TILE_SIZE - 1) / GEN_IMAGE_TILE_SIZE;
+    size_t tile_num = (size_t)tile_x_num * tile_y_num;
+
+    auto fill_tile = [&](size_t tile) {
+        int x0 = (int)(tile % tile_x_num) * GEN_IMAGE_TILE_SIZE;
+        int y0 = (int)(tile / tile_x_num) * GEN_IMAGE_TILE_SIZE;
+        int x1 = min(width, x0 + GEN_IMAGE_TILE_SIZE);
+        int y1 = min(height, y0 + GEN_IMAGE_TILE_SIZE);
+        Xoshiro256ssLanes<GEN_IMAGE_LANES> gen(random_seed(seed, tile));
+        for (int y = y0; y < y1; y++) {
+            gen_image_fill_row(gen, image.data() + (size_t)y * width + x0, x1 - x0, mask);
+        }
+    };
+
+    int worker_num = (int)min<size_t>(tile_num, (size_t)(thread_num > 0 ? thread_num : max(1, (int)std::thread::hardware_concurrency())));
+    if (worker_num <= 1) {
+        for (size_t tile = 0; tile < tile_num; tile++) {
+            fill_tile(tile);
+        }
+        return;
+    }
+    std::atomic<size_t> next_tile(0);
+    vector<std::thread> worker_list;
+    for (int t = 0; t < worker_num; t++) {
+        worker_list.push_back(std::thread([&]() {
+            for (size_t tile = next_tile++; tile < tile_num; tile = next_tile++) {
+                fill_tile(tile);
+            }
+        }));
+    }
+    for (size_t t = 0; t < worker_list.size(); t++) {
+        worker_list[t].join();
+    }
+}
+
+
+#endif // GEN_IMAGE_FUNCTION_H
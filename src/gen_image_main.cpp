@@ -3,13 +3,19 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
-#include <random>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdlib>
+#include <cstdio>
 
 // tool
 #include "json.hpp"
 #include "print_function.h"
 #include "vector_function.h"
 #include "parse_json_function.h"
+#include "random_function.h"
+#include "gen_image_function.h"
 
 // def
 #define GEN_IMAGE_MAIN_SECTION "[gen_image_main]"
@@ -19,56 +25,133 @@ using json = nlohmann::json;
 using namespace std;
 
 
+struct GenImageOption {
+    int width = 0;                  // 0: reg_image_width of the config
+    int height = 0;                 // 0: reg_image_height of the config
+    int bitwidth = 0;               // 0: src_image_data_bitwidth of the config
+    uint64_t seed = 1;
+    int thread_num = 0;             // 0: hardware concurrency
+    int frame_num = 1;
+    string output_path;             // empty: random_src_image_path of the config
+};
+
+
+// output path of frame f, frames beyond one get "_<f>" before the extension
+static string gen_image_frame_path(const string& output_path, int frame_num, int f) {
+    if (frame_num <= 1) {
+        return output_path;
+    }
+    char index[16];
+    snprintf(index, sizeof(index), "_%05d", f);
+    size_t dot_pos = output_path.find_last_of('.');
+    size_t slash_pos = output_path.find_last_of('/');
+    if (dot_pos == string::npos || (slash_pos != string::npos && dot_pos < slash_pos)) {
+        return output_path + index;
+    }
+    return output_path.substr(0, dot_pos) + index + output_path.substr(dot_pos);
+}
+
+static bool gen_image_write(const string& path, const vector<uint16_t>& image, int width, int height) {
+    if (vector_is_raw_path(path)) {
+        return vector_write_to_raw_file(path, image);
+    }
+    return vector_write_to_file(path, image, width, height);
+}
+
+
+// usage: gen_image_main [config.json] [--width N] [--height N] [--bitwidth N] [--seed N] [--threads N]
+//                       [--frames N] [--output path]
+// .raw / .bin outputs are written in the binary frame format, anything else as text; frame f uses
+// seed random_seed(seed, f) and goes to <output>_<f>.<ext> when --frames > 1
 int main(const int argc, const char *argv[]) {
     string config_path = "/home/sheldon/hls_project/vibe_crop/src/vibe.json";
+    GenImageOption option;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--width" && i + 1 < argc) {
+            option.width = atoi(argv[++i]);
+        } else if (arg == "--height" && i + 1 < argc) {
+            option.height = atoi(argv[++i]);
+        } else if (arg == "--bitwidth" && i + 1 < argc) {
+            option.bitwidth = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            option.seed = strtoull(argv[++i], nullptr, 0);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            option.thread_num = atoi(argv[++i]);
+        } else if (arg == "--frames" && i + 1 < argc) {
+            option.frame_num = max(1, atoi(argv[++i]));
+        } else if (arg == "--output" && i + 1 < argc) {
+            option.output_path = argv[++i];
+        } else {
+            config_path = arg;
+        }
+    }
+
     ifstream f(config_path);
     if (!f.is_open()) {
         MAIN_ERROR_1("Cannot open vibe.json configuration file");
     }
     MAIN_INFO_1("vibe.json configuration file path: " + config_path);
-    
+
     json data = json::parse(f);
     f.close();
-    MAIN_INFO_1("vibe.json configuration file parse follow...");
-    MAIN_INFO_1(data.dump(2));
-    
+
     // object loading
-    MAIN_INFO_1("object: image_info print follow...");
     ImageSection image_section = data["image_info"].get<ImageSection>();
-    MAIN_INFO_1("object: register_info print follow...");
+    OutputSection output_section = GetOutputSection(data);
     RegisterSection register_section = data["register_info"].get<RegisterSection>();
     MAIN_INFO_1("object: image_info print follow...");
     image_section.print_values();
-    MAIN_INFO_1("object: register_info print follow...");
-    register_section.print_values();
-    
-    int width = register_section.reg_image_width.reg_initial_value[0];
-    int height = register_section.reg_image_height.reg_initial_value[0];
-
-    vector<uint16_t> input_image;   
-
-    // 生成或读取输入图像 - 多路径兼容处理
-
-    if (image_section.generate_random_image == 1) {
-
-        main_info(GEN_IMAGE_MAIN_SECTION, "Random image generate enabled, width:height= " + to_string(width) + "x" + to_string(height));
-        // 生成随机图像
-        input_image.resize(width * height);
-        std::random_device rd;
-        std::mt19937 gen(rd());
-        std::uniform_int_distribution<> distrib(0, 255);
-        for (auto& pixel : input_image) {
-            pixel = static_cast<uint16_t>(distrib(gen));
-        }
 
-        string save_path = image_section.random_image_path;
-        if (vector_write_to_file(save_path, input_image, width, height)) {
-            main_info(GEN_IMAGE_MAIN_SECTION, "Random image write to file success: " + save_path);
-        } else {
-            main_info(GEN_IMAGE_MAIN_SECTION, "Random image write to file fail: " + save_path);
+    int width = option.width > 0 ? option.width : register_section.value("reg_image_width");
+    int height = option.height > 0 ? option.height : register_section.value("reg_image_height");
+    int bitwidth = option.bitwidth > 0 ? option.bitwidth : image_section.src_image_data_bitwidth;
+    string output_path = option.output_path.empty() ? output_section.random_src_image_path : option.output_path;
+    if (width <= 0 || height <= 0 || bitwidth <= 0 || bitwidth > 16) {
+        MAIN_ERROR_1("Unsupported random image " + to_string(width) + "x" + to_string(height) + ", " + to_string(bitwidth) + " bit");
+    }
+
+    // 生成随机图像, 只在配置打开或命令行给出输出路径时生成
+    if (image_section.generate_random_src_image_enable != 1 && option.output_path.empty()) {
+        main_info(GEN_IMAGE_MAIN_SECTION, "Random image generate disabled");
+        return 0;
+    }
+    main_info(GEN_IMAGE_MAIN_SECTION, "Random image generate enabled, width:height= " + to_string(width) + "x" + to_string(height)
+                                      + ", " + to_string(bitwidth) + " bit, seed " + to_string(option.seed)
+                                      + ", " + to_string(option.frame_num) + " frame(s)");
+
+    // frame f + 1 is generated while frame f is written
+    vector<uint16_t> frame_buffer[2];
+    std::thread writer;
+    bool write_ok = true;
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    for (int frame = 0; frame < option.frame_num; frame++) {
+        vector<uint16_t>& input_image = frame_buffer[frame & 1];
+        uint64_t frame_seed = (option.frame_num > 1) ? random_seed(option.seed, (uint64_t)frame) : option.seed;
+        gen_image_random(input_image, width, height, bitwidth, frame_seed, option.thread_num);
+        if (writer.joinable()) {
+            writer.join();
         }
+        string save_path = gen_image_frame_path(output_path, option.frame_num, frame);
+        writer = std::thread([&write_ok, &input_image, save_path, width, height]() {
+            if (!gen_image_write(save_path, input_image, width, height)) {
+                main_info(GEN_IMAGE_MAIN_SECTION, "Random image write to file fail: " + save_path);
+                write_ok = false;
+            }
+        });
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    double second = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
 
+    if (!write_ok) {
+        MAIN_ERROR_1("Random image write to file fail");
     }
-    
+    char line[256];
+    snprintf(line, sizeof(line), "Random image write to file success: %s (%d frame(s), %.3f s, %.1f MB/s)",
+             gen_image_frame_path(output_path, option.frame_num, 0).c_str(), option.frame_num, second,
+             second > 0 ? 2.0 * width * height * option.frame_num / second / 1e6 : 0.0);
+    main_info(GEN_IMAGE_MAIN_SECTION, line);
     return 0;
-}
\ No newline at end of file
+}
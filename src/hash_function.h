@@ -0,0 +1,41 @@
+#ifndef HASH_FUNCTION_H
+#define HASH_FUNCTION_H
+
+// 64-bit hashes over sample values, shared by the stage cache keys (vector_hash64) and the
+// per row / per tile hash manifests (hash_manifest_function.h)
+
+// std
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// def
+#define HASH64_FNV_OFFSET   0xcbf29ce484222325ULL
+#define HASH64_FNV_PRIME    0x100000001b3ULL
+
+
+// mix one value into a running 64-bit hash (splitmix64 finalizer)
+inline uint64_t hash64_combine(uint64_t seed, uint64_t value) {
+    uint64_t z = seed ^ (value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// FNV-1a style step over n sample values, independent of the storage type
+template <typename T>
+inline uint64_t hash64_update(uint64_t hash, const T* data, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        hash ^= static_cast<uint64_t>(data[i]);
+        hash *= HASH64_FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T, typename ALLOC>
+uint64_t vector_hash64(const std::vector<T, ALLOC>& data, uint64_t seed = HASH64_FNV_OFFSET) {
+    return hash64_update(seed, data.data(), data.size());
+}
+
+
+#endif // HASH_FUNCTION_H
@@ -0,0 +1,180 @@
+#ifndef HASH_MANIFEST_FUNCTION_H
+#define HASH_MANIFEST_FUNCTION_H
+
+// content hash manifest of a stage output, written next to the dump as <output path>.hash
+//  - one 64-bit hash per row and per tile_size x tile_size tile (tile values in raster order,
+//    hash64_update), plus one for the whole frame over the row hashes and the size
+//  - a 3840x2160 frame is ~4200 hashes, compare_function.h checks the manifests first and only
+//    reads the pixels of tiles whose hashes differ
+// text file:
+//   width <w> / height <h> / tile_size <t> / frame <hash>
+//   row <y> <hash>        one per row
+//   tile <tx> <ty> <hash> one per tile
+
+// std
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+
+// tool
+#include "hash_function.h"
+
+// def
+#define HASH_MANIFEST_SECTION       "[hash_manifest_function]"
+#define HASH_MANIFEST_SUFFIX        ".hash"
+#define HASH_MANIFEST_TILE_SIZE     64
+
+// using
+using namespace std;
+
+
+struct HashManifest {
+    int width = 0;
+    int height = 0;
+    int tile_size = HASH_MANIFEST_TILE_SIZE;
+    int tile_x_num = 0;
+    int tile_y_num = 0;
+    uint64_t frame_hash = 0;
+    vector<uint64_t> row_hash;
+    vector<uint64_t> tile_hash;     // tile_y_num x tile_x_num
+};
+
+
+inline string hash_manifest_path(const string& output_path) {
+    return output_path + HASH_MANIFEST_SUFFIX;
+}
+
+// row / tile hashes of a width x height frame in one pass
+template <typename T, typename ALLOC>
+HashManifest hash_manifest_build(const vector<T, ALLOC>& data, int width, int height, int tile_size = HASH_MANIFEST_TILE_SIZE) {
+    HashManifest manifest;
+    manifest.width = (width > 0 && height > 0) ? width : (int)data.size();
+    manifest.height = (width > 0 && height > 0) ? height : 1;
+    manifest.tile_size = tile_size;
+    manifest.tile_x_num = (manifest.width + tile_size - 1) / tile_size;
+    manifest.tile_y_num = (manifest.height + tile_size - 1) / tile_size;
+    manifest.row_hash.assign(manifest.height, HASH64_FNV_OFFSET);
+    manifest.tile_hash.assign((size_t)manifest.tile_x_num * manifest.tile_y_num, HASH64_FNV_OFFSET);
+
+    for (int y = 0; y < manifest.height; y++) {
+        size_t row_start = (size_t)y * manifest.width;
+        if (row_start >= data.size()) {
+            break;
+        }
+        size_t row_width = min<size_t>((size_t)manifest.width, data.size() - row_start);
+        uint64_t* tile_row = &manifest.tile_hash[(size_t)(y / tile_size) * manifest.tile_x_num];
+        for (size_t x0 = 0; x0 < row_width; x0 += tile_size) {
+            size_t n = min<size_t>(tile_size, row_width - x0);
+            tile_row[x0 / tile_size] = hash64_update(tile_row[x0 / tile_size], data.data() + row_start + x0, n);
+        }
+        manifest.row_hash[y] = hash64_update(HASH64_FNV_OFFSET, data.data() + row_start, row_width);
+    }
+
+    manifest.frame_hash = hash64_combine(hash64_combine(HASH64_FNV_OFFSET, manifest.width), manifest.height);
+    for (int y = 0; y < manifest.height; y++) {
+        manifest.frame_hash = hash64_combine(manifest.frame_hash, manifest.row_hash[y]);
+    }
+    return manifest;
+}
+
+inline bool hash_manifest_write(const string& path, const HashManifest& manifest) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cerr << "Cannot open output file: " << path << std::endl;
+        return false;
+    }
+    fprintf(file, "width %d\nheight %d\ntile_size %d\nframe %016llx\n", manifest.width, manifest.height, manifest.tile_size,
+            (unsigned long long)manifest.frame_hash);
+    for (int y = 0; y < manifest.height; y++) {
+        fprintf(file, "row %d %016llx\n", y, (unsigned long long)manifest.row_hash[y]);
+    }
+    for (int ty = 0; ty < manifest.tile_y_num; ty++) {
+        for (int tx = 0; tx < manifest.tile_x_num; tx++) {
+            fprintf(file, "tile %d %d %016llx\n", tx, ty, (unsigned long long)manifest.tile_hash[(size_t)ty * manifest.tile_x_num + tx]);
+        }
+    }
+    fclose(file);
+    return true;
+}
+
+inline bool hash_manifest_read(const string& path, HashManifest& manifest) {
+    ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    manifest = HashManifest();
+    string line;
+    while (getline(file, line)) {
+        istringstream iss(line);
+        string key;
+        iss >> key;
+        if (key == "width") {
+            iss >> manifest.width;
+        } else if (key == "height") {
+            iss >> manifest.height;
+        } else if (key == "tile_size") {
+            iss >> manifest.tile_size;
+        } else if (key == "tile") {
+            int tx, ty;
+            string hash;
+            iss >> tx >> ty >> hash;
+            manifest.tile_x_num = (manifest.width + manifest.tile_size - 1) / manifest.tile_size;
+            manifest.tile_y_num = (manifest.height + manifest.tile_size - 1) / manifest.tile_size;
+            manifest.tile_hash.resize((size_t)manifest.tile_x_num * manifest.tile_y_num, 0);
+            if (tx >= 0 && tx < manifest.tile_x_num && ty >= 0 && ty < manifest.tile_y_num) {
+                manifest.tile_hash[(size_t)ty * manifest.tile_x_num + tx] = strtoull(hash.c_str(), nullptr, 16);
+            }
+        } else if (key == "frame") {
+            string hash;
+            iss >> hash;
+            manifest.frame_hash = strtoull(hash.c_str(), nullptr, 16);
+        } else if (key == "row") {
+            int y;
+            string hash;
+            iss >> y >> hash;
+            manifest.row_hash.resize(manifest.height, 0);
+            if (y >= 0 && y < manifest.height) {
+                manifest.row_hash[y] = strtoull(hash.c_str(), nullptr, 16);
+            }
+        }
+    }
+    return manifest.width > 0 && manifest.height > 0 && (int)manifest.row_hash.size() == manifest.height
+           && manifest.tile_hash.size() == (size_t)manifest.tile_x_num * manifest.tile_y_num;
+}
+
+// the manifest of output_path if it exists and is not older than the dump
+inline bool hash_manifest_load(const string& output_path, HashManifest& manifest) {
+    struct stat output_stat;
+    struct stat manifest_stat;
+    string path = hash_manifest_path(output_path);
+    if (stat(output_path.c_str(), &output_stat) != 0 || stat(path.c_str(), &manifest_stat) != 0) {
+        return false;
+    }
+    if (manifest_stat.st_mtime < output_stat.st_mtime) {
+        return false;
+    }
+    return hash_manifest_read(path, manifest);
+}
+
+// dump + manifest, the manifest is written after the dump so it is never older
+template <typename T, typename ALLOC>
+bool hash_manifest_write_for(const string& output_path, const vector<T, ALLOC>& data, int width, int height) {
+    return hash_manifest_write(hash_manifest_path(output_path), hash_manifest_build(data, width, height));
+}
+
+// drops a dump and its manifest, for a stage output that is not written this run, so a stale one of
+// an earlier run is never compared (output_compare_main skips pairs missing on both sides)
+inline void hash_manifest_remove_for(const string& output_path) {
+    remove(output_path.c_str());
+    remove(hash_manifest_path(output_path).c_str());
+}
+
+
+#endif // HASH_MANIFEST_FUNCTION_H
@@ -0,0 +1,151 @@
+#ifndef HLS_AXIS_PACK_H
+#define HLS_AXIS_PACK_H
+
+// packed multi-sample AXI-Stream beats, HLS_PPC pixels of W bits per beat, shared by the kernels and
+// the C-sim harness so both sides agree on the layout
+//  - lane i = data[(i+1)*W-1 : i*W], TDATA rounded up to whole bytes: 3x10 bit in 32, 2x12 in 24,
+//    4x16 in 64, so 10/12 bit sensor data keeps its full range without a 16 bit container per pixel
+//  - every row starts on a new beat, keep covers the bytes of the valid lanes (partial last beat)
+//  - user(SOF) on the first beat of the frame, last(EOL) on the final beat of every row
+// HLS_AXIS_PACK_PPC(W) is the default packing, as many pixels as fit in 32 bits
+
+// std
+#include <ap_int.h>
+#include <hls_stream.h>
+#include "ap_axi_sdata.h"
+#ifndef __SYNTHESIS__
+#include <vector>
+#include <cstdint>
+#endif
+
+// tool
+#ifndef __SYNTHESIS__
+#include "print_function.h"
+#include "vector_function.h"
+#endif
+
+// ip
+#include "hls_info.h"
+
+// def
+#define HLS_AXIS_PACK_SECTION           "HlsAxisPack"
+#define HLS_AXIS_BEAT_BITS(W, PPC)      ((((W) * (PPC) + 7) / 8) * 8)
+#define HLS_AXIS_PACK_PPC(W)            ((W) >= 32 ? 1 : 32 / (W))
+
+
+template <int W, int HLS_PPC>
+struct HlsAxisPack {
+    // keep is per byte, with W < 8 several lanes share a byte and lane_num() cannot recover the lane count
+    static_assert(W >= 8, "HlsAxisPack needs W >= 8, keep marks whole bytes");
+    static_assert(HLS_PPC >= 1, "HlsAxisPack needs at least one pixel per beat");
+    static const int BEAT_BITS = HLS_AXIS_BEAT_BITS(W, HLS_PPC);
+    static const int KEEP_BITS = BEAT_BITS / 8;
+    typedef ap_uint<BEAT_BITS> data_t;
+    typedef ap_uint<KEEP_BITS> keep_t;
+    typedef ap_axiu<BEAT_BITS, 1, 0, 0> beat_t;
+
+    static hls_uint<W> get_lane(const data_t& data, int i) {
+        #pragma HLS INLINE
+        return hls_uint<W>(data.range((i + 1) * W - 1, i * W));
+    }
+
+    static void set_lane(data_t& data, int i, const hls_uint<W>& pixel) {
+        #pragma HLS INLINE
+        data.range((i + 1) * W - 1, i * W) = ap_uint<W>(pixel);
+    }
+
+    // keep/strb bits for the bytes covering the first lane_num lanes
+    static keep_t get_keep(hls_uint<16> lane_num) {
+        #pragma HLS INLINE
+        keep_t keep = 0;
+        hls_uint<16> byte_num = (lane_num * W + 7) / 8;
+        for (int i = 0; i < KEEP_BITS; i++) {
+            #pragma HLS UNROLL
+            keep[i] = (i < byte_num) ? 1 : 0;
+        }
+        return keep;
+    }
+
+#ifndef __SYNTHESIS__
+    // valid lanes of a beat from its keep, the inverse of get_keep
+    static int lane_num(const keep_t& keep) {
+        int byte_num = 0;
+        for (int i = 0; i < KEEP_BITS; i++) {
+            byte_num += keep[i] ? 1 : 0;
+        }
+        int lanes = byte_num * 8 / W;
+        return lanes < HLS_PPC ? lanes : HLS_PPC;
+    }
+
+    // one width x height frame appended to the stream, samples outside W bits handled by policy
+    // (as vector_to_stream), returns how many there were
+    template <typename IMAGE>
+    static size_t pack_frame(const IMAGE& image, int width, int height, hls_stream_t<beat_t>& beat_stream,
+                             StreamOverflowPolicy policy = STREAM_OVERFLOW_CLAMP) {
+        const int64_t max_value = (int64_t(1) << W) - 1;
+        size_t overflow_count = 0;
+        int beats_per_row = (width + HLS_PPC - 1) / HLS_PPC;
+        hls_stream_reserve(beat_stream, beat_stream.size() + (size_t)beats_per_row * height);
+        for (int y = 0; y < height; y++) {
+            for (int b = 0; b < beats_per_row; b++) {
+                beat_t beat;
+                beat.data = 0;
+                int lanes = (b == beats_per_row - 1) ? width - b * HLS_PPC : HLS_PPC;
+                for (int i = 0; i < lanes; i++) {
+                    int64_t value = static_cast<int64_t>(image[(size_t)y * width + b * HLS_PPC + i]);
+                    if (value < 0 || value > max_value) {
+                        if (policy == STREAM_OVERFLOW_ERROR) {
+                            main_error(HLS_AXIS_PACK_SECTION, "value " + std::to_string(value) + " at (" + std::to_string(y) + ", "
+                                       + std::to_string(b * HLS_PPC + i) + ") exceeds " + std::to_string(W) + "-bit range");
+                        }
+                        overflow_count++;
+                        value = (policy == STREAM_OVERFLOW_CLAMP) ? (value < 0 ? 0 : max_value) : (value & max_value);
+                    }
+                    beat.data.range((i + 1) * W - 1, i * W) = value;
+                }
+                beat.keep = get_keep(lanes);
+                beat.strb = beat.keep;
+                beat.user = (y == 0 && b == 0) ? 1 : 0;
+                beat.last = (b == beats_per_row - 1) ? 1 : 0;
+                beat_stream.write(beat);
+            }
+        }
+        if (overflow_count > 0) {
+            main_info(HLS_AXIS_PACK_SECTION, "Warning: " + std::to_string(overflow_count) + " values exceed " + std::to_string(W)
+                      + "-bit range, " + (policy == STREAM_OVERFLOW_CLAMP ? "clamped" : "masked"));
+        }
+        return overflow_count;
+    }
+
+    // next width x height frame off the stream, the lane count of every beat comes from keep
+    // false on a short stream, a lane count that does not match the row, or user/last not on
+    // exactly the SOF / EOL beats
+    template <typename IMAGE>
+    static bool unpack_frame(hls_stream_t<beat_t>& beat_stream, int width, int height, IMAGE& image) {
+        typedef typename IMAGE::value_type T;
+        int beats_per_row = (width + HLS_PPC - 1) / HLS_PPC;
+        bool framing_ok = true;
+        image.clear();
+        image.reserve((size_t)width * height);
+        for (int y = 0; y < height; y++) {
+            for (int b = 0; b < beats_per_row; b++) {
+                if (beat_stream.empty()) {
+                    return false;
+                }
+                beat_t beat = beat_stream.read();
+                int lanes = lane_num(beat.keep);
+                for (int i = 0; i < lanes; i++) {
+                    image.push_back(static_cast<T>(beat.data.range((i + 1) * W - 1, i * W)));
+                }
+                framing_ok &= (lanes == ((b == beats_per_row - 1) ? width - b * HLS_PPC : HLS_PPC));
+                framing_ok &= ((bool)beat.user == (y == 0 && b == 0));
+                framing_ok &= ((bool)beat.last == (b == beats_per_row - 1));
+            }
+        }
+        return framing_ok;
+    }
+#endif
+};
+
+
+#endif // HLS_AXIS_PACK_H
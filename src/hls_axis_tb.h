@@ -0,0 +1,244 @@
+#ifndef HLS_AXIS_TB_H
+#define HLS_AXIS_TB_H
+
+// AXI-Stream valid/ready testbench model on top of the HLS_CSIM_PROFILE cycle traces
+//  - the kernel runs once in C-sim with both streams traced (HLS_PROFILE_FIFO_TRACE), which gives
+//    the cycle of every input read and output write with an always-valid source and an
+//    always-ready sink
+//  - replay() plays those events against a TVALID pattern on the input and a TREADY pattern on the
+//    output: an II=1 pipeline stalls as a whole, so every cycle a read waits for TVALID or a write
+//    waits for TREADY pushes all later events back by one
+//  - a second replay with an unbounded skid FIFO in front of the sink gives the largest output
+//    buffering the kernel needs to never see TREADY back-pressure
+//    (bounded only if the sink keeps up on average, a slower sink makes it grow with the frame)
+// patterns: always, random:p (valid with probability p), bursty:on:off (random bursts, mean on/off
+// cycles), periodic:period:stall (stall cycles every period)
+
+#if !defined(HLS_CSIM_PROFILE) || defined(__SYNTHESIS__)
+#error "hls_axis_tb.h needs -DHLS_CSIM_PROFILE and is C-simulation only"
+#endif
+
+// std
+#include <vector>
+#include <string>
+#include <random>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+// tool
+#include "print_function.h"
+
+// ip
+#include "hls_csim_profile.h"
+
+// using
+using std::string;
+using std::vector;
+
+// def
+#define HLS_AXIS_TB_SECTION "HlsAxisTb"
+
+
+// per-cycle TVALID/TREADY, evaluated lazily and memoized so random patterns are reproducible
+class HlsAxisPattern {
+public:
+    enum PatternType { ALWAYS, RANDOM, BURSTY, PERIODIC };
+
+    HlsAxisPattern() : type(ALWAYS), probability(1.0), on_cycles(1), off_cycles(0), period(1), stall_cycles(0), seed(1) {}
+
+    // "always", "random:0.9", "bursty:64:16", "periodic:128:8"
+    static HlsAxisPattern parse(const string& spec, unsigned seed) {
+        HlsAxisPattern pattern;
+        pattern.spec = spec;
+        pattern.seed = seed;
+        vector<string> field;
+        size_t start = 0;
+        while (start <= spec.size()) {
+            size_t end = spec.find(':', start);
+            if (end == string::npos) {
+                end = spec.size();
+            }
+            field.push_back(spec.substr(start, end - start));
+            start = end + 1;
+        }
+        if (field[0] == "always" && field.size() == 1) {
+            pattern.type = ALWAYS;
+        } else if (field[0] == "random" && field.size() == 2) {
+            pattern.type = RANDOM;
+            pattern.probability = atof(field[1].c_str());
+        } else if (field[0] == "bursty" && field.size() == 3) {
+            pattern.type = BURSTY;
+            pattern.on_cycles = std::max(1, atoi(field[1].c_str()));
+            pattern.off_cycles = std::max(0, atoi(field[2].c_str()));
+        } else if (field[0] == "periodic" && field.size() == 3) {
+            pattern.type = PERIODIC;
+            pattern.period = std::max(1, atoi(field[1].c_str()));
+            pattern.stall_cycles = std::min(pattern.period - 1, std::max(0, atoi(field[2].c_str())));
+        } else {
+            main_error(HLS_AXIS_TB_SECTION, "unknown valid/ready pattern '" + spec + "'");
+        }
+        return pattern;
+    }
+
+    bool active(uint64_t cycle) {
+        if (type == ALWAYS) {
+            return true;
+        }
+        if (type == PERIODIC) {
+            return (cycle % period) >= (uint64_t)stall_cycles;
+        }
+        if (state.empty()) {
+            gen.seed(seed);
+        }
+        while (state.size() <= cycle) {
+            extend();
+        }
+        return state[cycle] != 0;
+    }
+
+    const string& name() const { return spec; }
+
+private:
+    void extend() {
+        if (type == RANDOM) {
+            state.push_back(std::bernoulli_distribution(probability)(gen) ? 1 : 0);
+            return;
+        }
+        // bursty: alternating geometric runs with the configured means
+        int on_num = std::geometric_distribution<int>(1.0 / on_cycles)(gen) + 1;
+        int off_num = off_cycles > 0 ? std::geometric_distribution<int>(1.0 / (off_cycles + 1))(gen) : 0;
+        state.insert(state.end(), on_num, 1);
+        state.insert(state.end(), off_num, 0);
+    }
+
+    PatternType type;
+    double probability;
+    int on_cycles;
+    int off_cycles;
+    int period;
+    int stall_cycles;
+    unsigned seed;
+    string spec;
+    std::mt19937 gen;
+    vector<uint8_t> state;
+};
+
+
+struct HlsAxisTbResult {
+    uint64_t cycles;                // first input handshake .. last output handshake
+    uint64_t input_stall_cycles;    // kernel waiting for TVALID
+    uint64_t output_stall_cycles;   // kernel waiting for TREADY
+    size_t output_buffer_peak;      // skid FIFO depth that hides all back-pressure
+    uint64_t buffered_cycles;       // cycles with that FIFO in place
+    double pixels_per_cycle;
+    double buffered_pixels_per_cycle;
+};
+
+
+// read_cycle / write_cycle: kernel clock of every input read / output write, always valid/ready
+inline HlsAxisTbResult hls_axis_tb_replay(const vector<uint64_t>& read_cycle, const vector<uint64_t>& write_cycle,
+                                          uint64_t frame_pixels, HlsAxisPattern valid_pattern, HlsAxisPattern ready_pattern) {
+    HlsAxisTbResult result = HlsAxisTbResult();
+
+    // both replays share the input side, writes only stall in the direct one
+    for (int buffered = 0; buffered < 2; buffered++) {
+        uint64_t delay = 0;
+        uint64_t input_stall = 0;
+        uint64_t output_stall = 0;
+        uint64_t last_cycle = 0;
+        vector<uint64_t> fifo_write_time;
+        size_t r = 0;
+        size_t w = 0;
+        while (r < read_cycle.size() || w < write_cycle.size()) {
+            // same kernel cycle: the read comes first, the write belongs to an earlier pixel
+            bool is_read = (r < read_cycle.size()) && (w >= write_cycle.size() || read_cycle[r] <= write_cycle[w]);
+            uint64_t t = (is_read ? read_cycle[r] : write_cycle[w]) + delay;
+            if (is_read) {
+                while (!valid_pattern.active(t)) {
+                    t++;
+                    input_stall++;
+                }
+                r++;
+            } else if (buffered) {
+                fifo_write_time.push_back(t);
+                w++;
+            } else {
+                while (!ready_pattern.active(t)) {
+                    t++;
+                    output_stall++;
+                }
+                w++;
+            }
+            delay = t - (is_read ? read_cycle[r - 1] : write_cycle[w - 1]);
+            last_cycle = std::max(last_cycle, t);
+        }
+
+        if (!buffered) {
+            result.cycles = last_cycle + 1;
+            result.input_stall_cycles = input_stall;
+            result.output_stall_cycles = output_stall;
+            continue;
+        }
+
+        // sink pops one beat per TREADY cycle, one cycle after the beat entered the FIFO
+        size_t peak = 0;
+        size_t pop_num = 0;
+        vector<uint64_t> pop_time(fifo_write_time.size());
+        uint64_t t = 0;
+        for (size_t k = 0; k < fifo_write_time.size(); k++) {
+            t = std::max(t, fifo_write_time[k] + 1);
+            while (!ready_pattern.active(t)) {
+                t++;
+            }
+            pop_time[k] = t;
+            t++;
+        }
+        for (size_t k = 0; k < fifo_write_time.size(); k++) {
+            while (pop_num < k && pop_time[pop_num] <= fifo_write_time[k]) {
+                pop_num++;
+            }
+            peak = std::max(peak, k + 1 - pop_num);
+        }
+        result.output_buffer_peak = peak;
+        result.buffered_cycles = std::max(last_cycle, pop_time.empty() ? 0 : pop_time.back()) + 1;
+    }
+
+    result.pixels_per_cycle = result.cycles ? (double)frame_pixels / result.cycles : 0;
+    result.buffered_pixels_per_cycle = result.buffered_cycles ? (double)frame_pixels / result.buffered_cycles : 0;
+    return result;
+}
+
+
+// runs kernel() once with both streams traced, collects its input read / output write cycles
+template <typename INPUT_STREAM, typename OUTPUT_STREAM, typename KERNEL>
+void hls_axis_tb_trace(INPUT_STREAM& input_stream, OUTPUT_STREAM& output_stream, KERNEL kernel,
+                       vector<uint64_t>& read_cycle, vector<uint64_t>& write_cycle) {
+    HLS_PROFILE_FIFO_TRACE(input_stream);
+    HLS_PROFILE_FIFO_TRACE(output_stream);
+    kernel();
+    map<const void*, HlsCsimFifoTrace>& trace_map = hls_csim_fifo_trace_map();
+    read_cycle.swap(trace_map[&input_stream].read_cycle);
+    write_cycle.swap(trace_map[&output_stream].write_cycle);
+    trace_map.erase(&input_stream);
+    trace_map.erase(&output_stream);
+}
+
+
+inline void hls_axis_tb_print(const string& kernel_name, HlsAxisPattern& valid_pattern, HlsAxisPattern& ready_pattern,
+                              const HlsAxisTbResult& result) {
+    char line[320];
+    snprintf(line, sizeof(line),
+             "%s valid=%s ready=%s: cycles %llu, pixels/cycle %.4f, TVALID stalls %llu, TREADY stalls %llu | "
+             "skid FIFO %llu beats -> cycles %llu, pixels/cycle %.4f",
+             kernel_name.c_str(), valid_pattern.name().c_str(), ready_pattern.name().c_str(),
+             (unsigned long long)result.cycles, result.pixels_per_cycle,
+             (unsigned long long)result.input_stall_cycles, (unsigned long long)result.output_stall_cycles,
+             (unsigned long long)result.output_buffer_peak, (unsigned long long)result.buffered_cycles,
+             result.buffered_pixels_per_cycle);
+    main_info(HLS_AXIS_TB_SECTION, line);
+}
+
+
+#endif // HLS_AXIS_TB_H
@@ -0,0 +1,113 @@
+// std
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "hls_info.h"
+#include "hls_csim_profile.h"
+#include "hls_axis_tb.h"
+#include "hls_axis_pack.h"
+#include "hls_crop_ppc.h"
+#include "hls_dpc.h"
+
+// def
+#define HLS_AXIS_TB_MAIN_SECTION "hls_axis_tb_main"
+
+// using
+using namespace std;
+
+
+// default TVALID / TREADY scenarios, a DMA that mostly keeps up plus the usual stall shapes
+static const char* hls_axis_tb_scenario[][2] = {
+    {"always", "always"},
+    {"random:0.9", "always"},
+    {"always", "random:0.9"},
+    {"bursty:64:16", "always"},
+    {"always", "bursty:64:16"},
+    {"periodic:128:8", "periodic:100:10"},
+};
+
+
+// random frame as HLS_PPC pixel beats
+template <int W, int HLS_PPC>
+void fill_beat_stream(mt19937& gen, int width, int height, hls_stream_t<typename HlsAxisPack<W, HLS_PPC>::beat_t>& beat_stream) {
+    frame_vector<uint16_t> image((size_t)width * height);
+    for (size_t i = 0; i < image.size(); i++) {
+        image[i] = gen() & ((1u << W) - 1);
+    }
+    HlsAxisPack<W, HLS_PPC>::pack_frame(image, width, height, beat_stream);
+}
+
+
+// one traced run of the kernel, then every scenario (or the one given) replayed on the trace
+template <int W, int HLS_PPC, typename KERNEL>
+void run_kernel(const string& kernel_name, KERNEL& kernel, const HlsRegisterSection& hls_regs, mt19937& gen,
+                const vector<pair<string, string>>& scenario_list, unsigned seed) {
+    int width = hls_regs.reg_image_width;
+    int height = hls_regs.reg_image_height;
+    hls_stream_t<typename HlsAxisPack<W, HLS_PPC>::beat_t> input_stream;
+    hls_stream_t<typename HlsAxisPack<W, HLS_PPC>::beat_t> output_stream;
+    hls_stream_reserve(input_stream, (size_t)((width + HLS_PPC - 1) / HLS_PPC) * height);
+    hls_stream_reserve(output_stream, (size_t)((width + HLS_PPC - 1) / HLS_PPC) * height);
+    fill_beat_stream<W, HLS_PPC>(gen, width, height, input_stream);
+
+    vector<uint64_t> read_cycle;
+    vector<uint64_t> write_cycle;
+    hls_axis_tb_trace(input_stream, output_stream, [&]() { kernel.run(input_stream, output_stream, hls_regs); },
+                      read_cycle, write_cycle);
+
+    for (size_t i = 0; i < scenario_list.size(); i++) {
+        HlsAxisPattern valid_pattern = HlsAxisPattern::parse(scenario_list[i].first, seed);
+        HlsAxisPattern ready_pattern = HlsAxisPattern::parse(scenario_list[i].second, seed + 1);
+        HlsAxisTbResult result = hls_axis_tb_replay(read_cycle, write_cycle, (uint64_t)width * height, valid_pattern, ready_pattern);
+        hls_axis_tb_print(kernel_name, valid_pattern, ready_pattern, result);
+    }
+}
+
+
+// usage: hls_axis_tb_main [width] [height] [seed] [valid_pattern ready_pattern]
+// patterns: always, random:p, bursty:on:off, periodic:period:stall
+int main(const int argc, const char *argv[]) {
+    int width = (argc > 1) ? atoi(argv[1]) : 1920;
+    int height = (argc > 2) ? atoi(argv[2]) : 64;
+    unsigned seed = (argc > 3) ? (unsigned)strtoul(argv[3], nullptr, 0) : 1u;
+    vector<pair<string, string>> scenario_list;
+    if (argc > 5) {
+        scenario_list.push_back(make_pair(string(argv[4]), string(argv[5])));
+    } else {
+        for (size_t i = 0; i < sizeof(hls_axis_tb_scenario) / sizeof(hls_axis_tb_scenario[0]); i++) {
+            scenario_list.push_back(make_pair(string(hls_axis_tb_scenario[i][0]), string(hls_axis_tb_scenario[i][1])));
+        }
+    }
+    MAIN_INFO_1("frame: " + to_string(width) + "x" + to_string(height) + ", seed: " + to_string(seed));
+    mt19937 gen(seed);
+
+    HlsRegisterSection hls_regs;
+    hls_regs.reg_image_width = width;
+    hls_regs.reg_image_height = height;
+    hls_regs.reg_crop_enable = 1;
+    hls_regs.reg_crop_start_x = width / 8;
+    hls_regs.reg_crop_start_y = height / 8;
+    hls_regs.reg_crop_end_x = width - width / 8 - 1;
+    hls_regs.reg_crop_end_y = height - height / 8 - 1;
+    hls_regs.reg_dpc_enable = 1;
+    hls_regs.reg_dpc_threshold = 30;
+
+    HlsDpc<8, 8, 1> hls_dpc_1;
+    HlsDpc<8, 8, 2> hls_dpc_2;
+    HlsCropPpc<8, 8, 1> hls_crop_1;
+    HlsCropPpc<8, 8, 2> hls_crop_2;
+    run_kernel<8, 1>("HlsDpc ppc=1", hls_dpc_1, hls_regs, gen, scenario_list, seed);
+    run_kernel<8, 2>("HlsDpc ppc=2", hls_dpc_2, hls_regs, gen, scenario_list, seed);
+    run_kernel<8, 1>("HlsCropPpc ppc=1", hls_crop_1, hls_regs, gen, scenario_list, seed);
+    run_kernel<8, 2>("HlsCropPpc ppc=2", hls_crop_2, hls_regs, gen, scenario_list, seed);
+    return 0;
+}
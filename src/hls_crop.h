@@ -11,6 +11,10 @@ using std::string;
 
 // ip
 #include "hls_info.h"
+#include "hls_csim_profile.h"
+
+// def
+#define HLS_CROP_SECTION "HlsCrop"
 
 
 template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH>
@@ -20,8 +24,8 @@ public:
     ~HlsCrop() {};  
 
     void run(
-        hls::stream<ap_axiu<HLS_INPUT_DATA_BITWIDTH, 0, 0, 0>>& input_stream,
-        hls::stream<ap_axiu<HLS_OUTPUT_DATA_BITWIDTH, 0, 0, 0>>& output_stream,
+        hls_stream_t<ap_axiu<HLS_INPUT_DATA_BITWIDTH, 1, 0, 0>>& input_stream,
+        hls_stream_t<ap_axiu<HLS_OUTPUT_DATA_BITWIDTH, 1, 0, 0>>& output_stream,
         const HlsRegisterSection& hls_register_section
     ) {
         #pragma HLS INTERFACE axis port=input_stream
@@ -32,67 +36,65 @@ public:
         // 防止编译器优化掉未使用的regs
         HlsRegisterSection dummy = hls_register_section;
 
+        HLS_PROFILE_BEGIN(HLS_CROP_SECTION);
+
         if (!hls_register_section.reg_crop_enable) {
             // 如果crop未启用，直接透传所有数据（包括last信号）
             // 使用两层for循环实现数据透传，与裁剪模式结构一致
-            ap_uint<16> y_cnt = 0;
-            ap_uint<16> x_cnt = 0;
+            hls_uint<16> y_cnt = 0;
+            hls_uint<16> x_cnt = 0;
             
             for(y_cnt = 0; y_cnt < hls_register_section.reg_image_height; y_cnt++) {
                 for(x_cnt = 0; x_cnt < hls_register_section.reg_image_width; x_cnt++) {
                     #pragma HLS PIPELINE II=1
-                    ap_axiu<HLS_INPUT_DATA_BITWIDTH, 0, 0, 0> data_pkt = input_stream.read();
+                    HLS_PROFILE_LOOP("crop_bypass", 1);
+                    HLS_PROFILE_READ(input_stream);
+                    ap_axiu<HLS_INPUT_DATA_BITWIDTH, 1, 0, 0> data_pkt = input_stream.read();
+                    // user(SOF)在帧首，last(EOL)在每行行尾
+                    data_pkt.user = (y_cnt == 0 && x_cnt == 0) ? 1 : 0;
+                    data_pkt.last = (x_cnt == hls_register_section.reg_image_width - 1) ? 1 : 0;
+                    HLS_PROFILE_WRITE(output_stream);
                     output_stream.write(data_pkt);
                 }
             }
+            HLS_PROFILE_END(HLS_CROP_SECTION, hls_register_section.reg_image_width, hls_register_section.reg_image_height);
             return;
         }
         
         // 处理每个像素
-        ap_uint<16> y_cnt = 0;
-        ap_uint<16> x_cnt = 0;
-        ap_uint<32> output_count = 0;
-        ap_uint<32> expected_output = (ap_uint<32>(hls_register_section.reg_crop_end_y) - hls_register_section.reg_crop_start_y + 1) * 
-                                    (ap_uint<32>(hls_register_section.reg_crop_end_x) - hls_register_section.reg_crop_start_x + 1);
-        
-        // 需要跟踪当前帧是否结束
-        bool frame_end = false;
-        
+        hls_uint<16> y_cnt = 0;
+        hls_uint<16> x_cnt = 0;
+        hls_uint<32> output_count = 0;
+
         for(y_cnt=0; y_cnt<hls_register_section.reg_image_height; y_cnt++){
             for(x_cnt=0; x_cnt<hls_register_section.reg_image_width; x_cnt++){
                 #pragma HLS PIPELINE II=1
-                ap_axiu<HLS_INPUT_DATA_BITWIDTH, 0, 0, 0> data_pkt = input_stream.read();
+                HLS_PROFILE_LOOP("crop", 1);
+                HLS_PROFILE_READ(input_stream);
+                ap_axiu<HLS_INPUT_DATA_BITWIDTH, 1, 0, 0> data_pkt = input_stream.read();
                 
                 // 检查是否在裁剪区域内
                 bool x_in_range = (x_cnt >= hls_register_section.reg_crop_start_x && x_cnt <= hls_register_section.reg_crop_end_x);
                 bool y_in_range = (y_cnt >= hls_register_section.reg_crop_start_y && y_cnt <= hls_register_section.reg_crop_end_y);
                 bool in_crop_region = (x_in_range && y_in_range);
                 
-                // 检查是否到达帧尾
-                if (data_pkt.last == 1) {
-                    frame_end = true;
-                }
-                
                 if (in_crop_region) {
                     output_count++;
                 }
-                
-                bool crop_count_end = (output_count == expected_output);
-                
-                // 如果是裁剪区域的最后一个像素，设置last信号
-                if (crop_count_end) {
-                    data_pkt.last = 1;
-                } else if (!frame_end) {
-                    // 如果不是原始帧的结束，保持last为0
-                    data_pkt.last = 0;
-                }
-                // 如果是原始帧的结束且在裁剪区域外，则不修改last信号
+
+                // user(SOF)标记裁剪后的第一个像素
+                data_pkt.user = (in_crop_region && output_count == 1) ? 1 : 0;
+
+                // last(EOL)标记裁剪区域每行的最后一个像素
+                data_pkt.last = (x_cnt == hls_register_section.reg_crop_end_x) ? 1 : 0;
 
                 if (in_crop_region) {
+                    HLS_PROFILE_WRITE(output_stream);
                     output_stream.write(data_pkt);
                 }
             }
         }
+        HLS_PROFILE_END(HLS_CROP_SECTION, hls_register_section.reg_image_width, hls_register_section.reg_image_height);
     }
 
 
@@ -0,0 +1,200 @@
+#ifndef HLS_CROP_MAXI_H
+#define HLS_CROP_MAXI_H
+
+// crop that fetches only the ROI from DDR over m_axi instead of streaming the whole frame in
+//  - frame layout: one pixel per HLS_CROP_MAXI_PIXEL_BITS container (8 bit up to 8 bit data, else
+//    16 bit, same as frame_vector<uint8_t/uint16_t>), every row starts on a new bus word
+//  - per ROI row the words covering [crop_start_x, crop_end_x] are read as one burst of consecutive
+//    addresses starting on a word boundary (split into HLS_CROP_MAXI_BURST_LENGTH beat bursts by
+//    the m_axi adapter), rows outside [crop_start_y, crop_end_y] are never read
+//  - read and unpack are DATAFLOW processes, the output stream is one pixel per beat with the
+//    HlsCrop framing (user on the first ROI pixel, last on the final pixel of every ROI row)
+// C-sim counts the bytes fetched, report_bandwidth() compares them with the full frame a
+// streaming HlsCrop has to read
+
+// std
+#include <ap_int.h>
+#include <hls_stream.h>
+#include "ap_axi_sdata.h"
+#ifndef __SYNTHESIS__
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#endif
+
+// ip
+#include "hls_info.h"
+#include "hls_csim_profile.h"
+#include "hls_axis_pack.h"
+#ifndef __SYNTHESIS__
+#include "print_function.h"
+#endif
+
+// def
+#define HLS_CROP_MAXI_SECTION           "HlsCropMaxi"
+#ifndef HLS_CROP_MAXI_BUS_BITWIDTH
+#define HLS_CROP_MAXI_BUS_BITWIDTH      64      // m_axi data width, 64/128 on the Zynq HP ports
+#endif
+#define HLS_CROP_MAXI_BURST_LENGTH      64      // beats per AXI burst
+#define HLS_CROP_MAXI_WORD_DEPTH        (2 * HLS_CROP_MAXI_BURST_LENGTH)    // read -> unpack FIFO
+
+
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_BUS_BITWIDTH = HLS_CROP_MAXI_BUS_BITWIDTH>
+class HlsCropMaxi {
+public:
+    static const int HLS_CROP_MAXI_PIXEL_BITS = (HLS_INPUT_DATA_BITWIDTH <= 8) ? 8 : 16;
+    static const int PIXELS_PER_WORD = HLS_BUS_BITWIDTH / HLS_CROP_MAXI_PIXEL_BITS;
+    static_assert(HLS_INPUT_DATA_BITWIDTH <= 16, "HlsCropMaxi stores pixels in 8 or 16 bit containers");
+    static_assert(HLS_BUS_BITWIDTH % HLS_CROP_MAXI_PIXEL_BITS == 0, "bus width must hold whole pixels");
+
+    typedef ap_uint<HLS_BUS_BITWIDTH> bus_word_t;
+    typedef typename HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, 1>::beat_t output_beat_t;
+
+    HlsCropMaxi() {
+#ifndef __SYNTHESIS__
+        fetched_bytes = 0;
+        burst_num = 0;
+#endif
+    };
+    ~HlsCropMaxi() {};
+
+    void run(
+        const bus_word_t* frame,
+        hls_stream_t<output_beat_t>& output_stream,
+        const HlsRegisterSection& hls_register_section
+    ) {
+        #pragma HLS INTERFACE m_axi port=frame offset=slave bundle=gmem max_read_burst_length=HLS_CROP_MAXI_BURST_LENGTH num_read_outstanding=4
+        #pragma HLS INTERFACE axis port=output_stream
+        #pragma HLS INTERFACE s_axilite port=frame bundle=control
+        #pragma HLS INTERFACE s_axilite port=hls_register_section bundle=control
+        #pragma HLS INTERFACE s_axilite port=return bundle=control
+        #pragma HLS DATAFLOW
+
+#ifndef __SYNTHESIS__
+        fetched_bytes = 0;
+        burst_num = 0;
+#endif
+
+        hls_stream_t<bus_word_t> word_stream("crop_maxi_word_stream");
+        #pragma HLS STREAM variable=word_stream depth=HLS_CROP_MAXI_WORD_DEPTH
+#if defined(HLS_THREADED_DATAFLOW) && !defined(__SYNTHESIS__)
+        hls_stream_set_depth(word_stream, HLS_CROP_MAXI_WORD_DEPTH);
+#endif
+
+        HLS_DATAFLOW_BEGIN("HlsCropMaxi");
+        HLS_DATAFLOW_PROCESS("read", read_roi(frame, word_stream, hls_register_section));
+        HLS_DATAFLOW_PROCESS("unpack", unpack_roi(word_stream, output_stream, hls_register_section));
+        HLS_DATAFLOW_END();
+    }
+
+#ifndef __SYNTHESIS__
+    // frame -> DDR layout read by run(), rows padded to whole bus words
+    template <typename IMAGE>
+    static void pack_frame(const IMAGE& image, int width, int height, std::vector<bus_word_t>& frame) {
+        int stride_words = (width + PIXELS_PER_WORD - 1) / PIXELS_PER_WORD;
+        frame.assign((size_t)stride_words * height, bus_word_t(0));
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                bus_word_t& word = frame[(size_t)y * stride_words + x / PIXELS_PER_WORD];
+                int lane = x % PIXELS_PER_WORD;
+                word.range((lane + 1) * HLS_CROP_MAXI_PIXEL_BITS - 1, lane * HLS_CROP_MAXI_PIXEL_BITS) = image[(size_t)y * width + x];
+            }
+        }
+    }
+
+    // bytes the streaming crop reads for the same frame (whole padded rows) vs the ROI bursts
+    uint64_t frame_bytes(const HlsRegisterSection& hls_register_section) const {
+        uint64_t stride_words = (hls_register_section.reg_image_width + PIXELS_PER_WORD - 1) / PIXELS_PER_WORD;
+        return stride_words * hls_register_section.reg_image_height * (HLS_BUS_BITWIDTH / 8);
+    }
+
+    void report_bandwidth(const HlsRegisterSection& hls_register_section) const {
+        uint64_t full_bytes = frame_bytes(hls_register_section);
+        char line[256];
+        snprintf(line, sizeof(line), "fetched %llu bytes in %llu row bursts, streaming crop reads %llu bytes, saved %.1f%%",
+                 (unsigned long long)fetched_bytes, (unsigned long long)burst_num, (unsigned long long)full_bytes,
+                 full_bytes ? 100.0 * (1.0 - (double)fetched_bytes / full_bytes) : 0.0);
+        main_info(HLS_CROP_MAXI_SECTION, line);
+    }
+
+    uint64_t fetched_bytes;         // m_axi read beats * bus bytes of the last run
+    uint64_t burst_num;             // row bursts of the last run, before the BURST_LENGTH split
+#endif
+
+private:
+    // ROI, the whole frame when crop is disabled
+    static void get_roi(const HlsRegisterSection& hls_register_section,
+                        hls_uint<16>& start_x, hls_uint<16>& end_x, hls_uint<16>& start_y, hls_uint<16>& end_y) {
+        if (hls_register_section.reg_crop_enable) {
+            start_x = hls_register_section.reg_crop_start_x;
+            end_x = hls_register_section.reg_crop_end_x;
+            start_y = hls_register_section.reg_crop_start_y;
+            end_y = hls_register_section.reg_crop_end_y;
+        } else {
+            start_x = 0;
+            end_x = hls_register_section.reg_image_width - 1;
+            start_y = 0;
+            end_y = hls_register_section.reg_image_height - 1;
+        }
+    }
+
+    // word aligned burst per ROI row, sequential addresses so the loop infers one burst per row
+    void read_roi(const bus_word_t* frame, hls_stream_t<bus_word_t>& word_stream, const HlsRegisterSection& hls_register_section) {
+        hls_uint<16> start_x, end_x, start_y, end_y;
+        get_roi(hls_register_section, start_x, end_x, start_y, end_y);
+        hls_uint<16> stride_words = (hls_register_section.reg_image_width + PIXELS_PER_WORD - 1) / PIXELS_PER_WORD;
+        hls_uint<16> first_word = start_x / PIXELS_PER_WORD;
+        hls_uint<16> words_per_row = end_x / PIXELS_PER_WORD - first_word + 1;
+
+        for (hls_uint<16> y_cnt = start_y; y_cnt <= end_y; y_cnt++) {
+            hls_uint<32> row_offset = hls_uint<32>(y_cnt) * stride_words + first_word;
+            for (hls_uint<16> w_cnt = 0; w_cnt < words_per_row; w_cnt++) {
+                #pragma HLS PIPELINE II=1
+                #pragma HLS LOOP_TRIPCOUNT min=1 max=1024
+                word_stream.write(frame[row_offset + w_cnt]);
+            }
+#ifndef __SYNTHESIS__
+            fetched_bytes += (uint64_t)words_per_row * (HLS_BUS_BITWIDTH / 8);
+            burst_num++;
+#endif
+        }
+    }
+
+    // words -> one pixel per beat, a new word at the row start and whenever the lane wraps
+    void unpack_roi(hls_stream_t<bus_word_t>& word_stream, hls_stream_t<output_beat_t>& output_stream,
+                    const HlsRegisterSection& hls_register_section) {
+        HLS_PROFILE_BEGIN(HLS_CROP_MAXI_SECTION);
+        hls_uint<16> start_x, end_x, start_y, end_y;
+        get_roi(hls_register_section, start_x, end_x, start_y, end_y);
+        hls_uint<16> crop_width = end_x - start_x + 1;
+        hls_uint<16> crop_height = end_y - start_y + 1;
+        hls_uint<16> first_lane = start_x % PIXELS_PER_WORD;
+
+        bus_word_t word = 0;
+        for (hls_uint<16> y_cnt = 0; y_cnt < crop_height; y_cnt++) {
+            hls_uint<16> lane = first_lane;
+            for (hls_uint<16> x_cnt = 0; x_cnt < crop_width; x_cnt++) {
+                #pragma HLS PIPELINE II=1
+                HLS_PROFILE_LOOP("crop_maxi", 1);
+                if (x_cnt == 0 || lane == 0) {
+                    HLS_PROFILE_READ(word_stream);
+                    word = word_stream.read();
+                }
+                output_beat_t output_beat;
+                output_beat.data = ap_uint<HLS_OUTPUT_DATA_BITWIDTH>(hls_uint<HLS_INPUT_DATA_BITWIDTH>(
+                    word.range(lane * HLS_CROP_MAXI_PIXEL_BITS + HLS_INPUT_DATA_BITWIDTH - 1, lane * HLS_CROP_MAXI_PIXEL_BITS)));
+                output_beat.keep = -1;
+                output_beat.strb = -1;
+                output_beat.user = (y_cnt == 0 && x_cnt == 0) ? 1 : 0;
+                output_beat.last = (x_cnt == crop_width - 1) ? 1 : 0;
+                HLS_PROFILE_WRITE(output_stream);
+                output_stream.write(output_beat);
+                lane = (lane == PIXELS_PER_WORD - 1) ? hls_uint<16>(0) : hls_uint<16>(lane + 1);
+            }
+        }
+        HLS_PROFILE_END(HLS_CROP_MAXI_SECTION, crop_width, crop_height);
+    }
+};
+
+
+#endif // HLS_CROP_MAXI_H
@@ -0,0 +1,160 @@
+// std
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "alg_info.h"
+#include "alg_crop.h"
+#include "hls_info.h"
+#include "hls_axis_pack.h"
+#include "hls_crop_maxi.h"
+
+// def
+#define HLS_CROP_MAXI_MAIN_SECTION "hls_crop_maxi_main"
+#define HLS_CROP_MAXI_CHECK_MAX_WIDTH   300
+#define HLS_CROP_MAXI_CHECK_MAX_HEIGHT  40
+
+// using
+using namespace std;
+
+
+// ROI windows of a 1920x1080 frame for the bandwidth report, {start_x, start_y, end_x, end_y}
+static const int hls_crop_maxi_roi[][4] = {
+    {0, 0, 1919, 1079},         // full frame
+    {240, 135, 1679, 944},      // centre 75%
+    {480, 270, 1439, 809},      // centre 50%
+    {3, 501, 130, 578},         // small unaligned window
+    {0, 0, 1919, 0},            // one row
+};
+
+
+// random frame sizes and crop windows, HlsCropMaxi vs AlgCrop
+template <int W, typename T, int HLS_BUS_BITWIDTH>
+int check_crop_maxi(mt19937& gen, int trial_num) {
+    int fail_num = 0;
+    for (int trial = 0; trial < trial_num; trial++) {
+        AlgRegisterSection alg_regs;
+        alg_regs.reg_image_width = uniform_int_distribution<int>(1, HLS_CROP_MAXI_CHECK_MAX_WIDTH)(gen);
+        alg_regs.reg_image_height = uniform_int_distribution<int>(1, HLS_CROP_MAXI_CHECK_MAX_HEIGHT)(gen);
+        alg_regs.reg_crop_enable = (trial % 8) != 0;
+        alg_regs.reg_crop_start_x = uniform_int_distribution<int>(0, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_end_x = uniform_int_distribution<int>(alg_regs.reg_crop_start_x, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_start_y = uniform_int_distribution<int>(0, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_crop_end_y = uniform_int_distribution<int>(alg_regs.reg_crop_start_y, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_dpc_enable = false;
+        alg_regs.reg_dpc_threshold = 0;
+
+        HlsRegisterSection hls_regs;
+        hls_regs.reg_image_width = alg_regs.reg_image_width;
+        hls_regs.reg_image_height = alg_regs.reg_image_height;
+        hls_regs.reg_crop_enable = alg_regs.reg_crop_enable;
+        hls_regs.reg_crop_start_x = alg_regs.reg_crop_start_x;
+        hls_regs.reg_crop_start_y = alg_regs.reg_crop_start_y;
+        hls_regs.reg_crop_end_x = alg_regs.reg_crop_end_x;
+        hls_regs.reg_crop_end_y = alg_regs.reg_crop_end_y;
+        hls_regs.reg_dpc_enable = 0;
+        hls_regs.reg_dpc_threshold = 0;
+
+        frame_vector<T> input_image(alg_regs.reg_image_width * alg_regs.reg_image_height);
+        uniform_int_distribution<int> pixel_distrib(0, (1 << W) - 1);
+        for (size_t i = 0; i < input_image.size(); i++) {
+            input_image[i] = pixel_distrib(gen);
+        }
+
+        // alg reference
+        frame_vector<T> alg_output_image;
+        AlgCrop<T, T> alg_crop;
+        alg_crop.run(input_image, alg_output_image, alg_regs);
+
+        // hls
+        typedef HlsCropMaxi<W, W, HLS_BUS_BITWIDTH> crop_maxi_t;
+        vector<typename crop_maxi_t::bus_word_t> frame;
+        crop_maxi_t::pack_frame(input_image, alg_regs.reg_image_width, alg_regs.reg_image_height, frame);
+        hls_stream_t<typename crop_maxi_t::output_beat_t> hls_output_stream;
+        crop_maxi_t hls_crop_maxi;
+        hls_crop_maxi.run(frame.data(), hls_output_stream, hls_regs);
+
+        frame_vector<T> hls_output_image;
+        int output_width = alg_regs.reg_crop_enable ? alg_regs.reg_crop_end_x - alg_regs.reg_crop_start_x + 1 : alg_regs.reg_image_width;
+        int output_height = alg_regs.reg_crop_enable ? alg_regs.reg_crop_end_y - alg_regs.reg_crop_start_y + 1 : alg_regs.reg_image_height;
+        bool framing_ok = HlsAxisPack<W, 1>::unpack_frame(hls_output_stream, output_width, output_height, hls_output_image) && hls_output_stream.empty();
+        bool data_ok = (hls_output_image == alg_output_image);
+        bool bytes_ok = hls_crop_maxi.fetched_bytes <= hls_crop_maxi.frame_bytes(hls_regs);
+
+        if (!framing_ok || !data_ok || !bytes_ok) {
+            fail_num++;
+            MAIN_INFO_1("crop maxi w=" + to_string(W) + " bus=" + to_string(HLS_BUS_BITWIDTH) + " trial " + to_string(trial) + " FAIL: "
+                        + to_string(alg_regs.reg_image_width) + "x" + to_string(alg_regs.reg_image_height)
+                        + " enable=" + to_string(alg_regs.reg_crop_enable)
+                        + " x=[" + to_string(alg_regs.reg_crop_start_x) + "," + to_string(alg_regs.reg_crop_end_x) + "]"
+                        + " y=[" + to_string(alg_regs.reg_crop_start_y) + "," + to_string(alg_regs.reg_crop_end_y) + "]"
+                        + (framing_ok ? "" : " framing") + (data_ok ? "" : " data") + (bytes_ok ? "" : " bytes"));
+        }
+    }
+    MAIN_INFO_1("crop maxi w=" + to_string(W) + " bus=" + to_string(HLS_BUS_BITWIDTH) + ": "
+                + to_string(trial_num - fail_num) + "/" + to_string(trial_num) + " passed");
+    return fail_num;
+}
+
+
+// bytes fetched for the report windows
+template <int W, typename T>
+void report_crop_maxi() {
+    HlsRegisterSection hls_regs;
+    hls_regs.reg_image_width = 1920;
+    hls_regs.reg_image_height = 1080;
+    hls_regs.reg_crop_enable = 1;
+    hls_regs.reg_dpc_enable = 0;
+    hls_regs.reg_dpc_threshold = 0;
+
+    typedef HlsCropMaxi<W, W> crop_maxi_t;
+    frame_vector<T> input_image((size_t)hls_regs.reg_image_width * hls_regs.reg_image_height, T(0));
+    vector<typename crop_maxi_t::bus_word_t> frame;
+    crop_maxi_t::pack_frame(input_image, hls_regs.reg_image_width, hls_regs.reg_image_height, frame);
+
+    for (size_t i = 0; i < sizeof(hls_crop_maxi_roi) / sizeof(hls_crop_maxi_roi[0]); i++) {
+        hls_regs.reg_crop_start_x = hls_crop_maxi_roi[i][0];
+        hls_regs.reg_crop_start_y = hls_crop_maxi_roi[i][1];
+        hls_regs.reg_crop_end_x = hls_crop_maxi_roi[i][2];
+        hls_regs.reg_crop_end_y = hls_crop_maxi_roi[i][3];
+        hls_stream_t<typename crop_maxi_t::output_beat_t> hls_output_stream;
+        hls_stream_reserve(hls_output_stream, (size_t)(hls_crop_maxi_roi[i][2] - hls_crop_maxi_roi[i][0] + 1) * (hls_crop_maxi_roi[i][3] - hls_crop_maxi_roi[i][1] + 1));
+        crop_maxi_t hls_crop_maxi;
+        hls_crop_maxi.run(frame.data(), hls_output_stream, hls_regs);
+        MAIN_INFO_1("w=" + to_string(W) + " roi x=[" + to_string(hls_crop_maxi_roi[i][0]) + "," + to_string(hls_crop_maxi_roi[i][2])
+                    + "] y=[" + to_string(hls_crop_maxi_roi[i][1]) + "," + to_string(hls_crop_maxi_roi[i][3]) + "]");
+        hls_crop_maxi.report_bandwidth(hls_regs);
+    }
+}
+
+
+// usage: hls_crop_maxi_main [trial_num] [seed]
+int main(const int argc, const char *argv[]) {
+    int trial_num = (argc > 1) ? atoi(argv[1]) : 200;
+    unsigned seed = (argc > 2) ? (unsigned)strtoul(argv[2], nullptr, 0) : 1u;
+    MAIN_INFO_1("trial num: " + to_string(trial_num) + ", seed: " + to_string(seed));
+    mt19937 gen(seed);
+
+    int fail_num = 0;
+    fail_num += check_crop_maxi<8, uint8_t, 64>(gen, trial_num);
+    fail_num += check_crop_maxi<8, uint8_t, 32>(gen, trial_num);
+    fail_num += check_crop_maxi<12, uint16_t, 64>(gen, trial_num);
+    fail_num += check_crop_maxi<16, uint16_t, 32>(gen, trial_num);
+
+    report_crop_maxi<8, uint8_t>();
+    report_crop_maxi<12, uint16_t>();
+
+    if (fail_num > 0) {
+        MAIN_ERROR_1(to_string(fail_num) + " checks failed");
+    }
+    MAIN_INFO_1("all checks passed");
+    return 0;
+}
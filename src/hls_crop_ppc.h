@@ -0,0 +1,158 @@
+#ifndef HLS_CROP_PPC_H
+#define HLS_CROP_PPC_H
+
+// std
+#include <ap_int.h>
+#include <hls_stream.h>
+#include "ap_axi_sdata.h"
+
+// using
+using std::string;
+
+// ip
+#include "hls_info.h"
+#include "hls_csim_profile.h"
+#include "hls_axis_pack.h"
+
+// def
+#define HLS_CROP_PPC_SECTION "HlsCropPpc"
+
+
+// HlsCrop with HLS_PPC pixels per clock (1/2/4/8)
+//  - one AXI-Stream beat (HlsAxisPack) carries HLS_PPC pixels, lane i = data[(i+1)*W-1 : i*W], pixel x = beat*HLS_PPC + i
+//  - every row starts on a new beat, the last beat of a row may be partial (keep covers the valid lanes only)
+//  - crop edges can fall mid-beat, the kept lanes are repacked so every output row is dense from lane 0
+//  - user(SOF) on the first output beat, last(EOL) on the final output beat of every row
+// when crop_width is not a multiple of HLS_PPC each row takes beats_per_row + 1 iterations,
+// the extra one flushes the lanes still pending at the row end
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC>
+class HlsCropPpc {
+public:
+    typedef HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC> input_pack_t;
+    typedef HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC> output_pack_t;
+    typedef typename input_pack_t::beat_t input_beat_t;
+    typedef typename output_pack_t::beat_t output_beat_t;
+
+    HlsCropPpc() {};
+    ~HlsCropPpc() {};
+
+    void run(
+        hls_stream_t<input_beat_t>& input_stream,
+        hls_stream_t<output_beat_t>& output_stream,
+        const HlsRegisterSection& hls_register_section
+    ) {
+        #pragma HLS INTERFACE axis port=input_stream
+        #pragma HLS INTERFACE axis port=output_stream
+        #pragma HLS INTERFACE s_axilite port=hls_register_section bundle=control
+        #pragma HLS INTERFACE s_axilite port=return bundle=control
+
+        HLS_PROFILE_BEGIN(HLS_CROP_PPC_SECTION);
+
+        hls_uint<16> image_width = hls_register_section.reg_image_width;
+        hls_uint<16> image_height = hls_register_section.reg_image_height;
+        hls_uint<16> beats_per_row = (image_width + HLS_PPC - 1) / HLS_PPC;
+
+        if (!hls_register_section.reg_crop_enable) {
+            // 透传，只做lane位宽转换，keep按行尾的有效lane重新计算
+            for (hls_uint<16> y_cnt = 0; y_cnt < image_height; y_cnt++) {
+                for (hls_uint<16> b_cnt = 0; b_cnt < beats_per_row; b_cnt++) {
+                    #pragma HLS PIPELINE II=1
+                    HLS_PROFILE_LOOP("crop_ppc_bypass", 1);
+                    HLS_PROFILE_READ(input_stream);
+                    input_beat_t input_beat = input_stream.read();
+                    output_beat_t output_beat;
+                    hls_uint<16> lane_num = image_width - b_cnt * HLS_PPC;
+                    if (lane_num > HLS_PPC) {
+                        lane_num = HLS_PPC;
+                    }
+                    output_beat.data = 0;
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        output_pack_t::set_lane(output_beat.data, i, input_pack_t::get_lane(input_beat.data, i));
+                    }
+                    output_beat.keep = output_pack_t::get_keep(lane_num);
+                    output_beat.strb = output_beat.keep;
+                    output_beat.user = (y_cnt == 0 && b_cnt == 0) ? 1 : 0;
+                    output_beat.last = (b_cnt == beats_per_row - 1) ? 1 : 0;
+                    HLS_PROFILE_WRITE(output_stream);
+                    output_stream.write(output_beat);
+                }
+            }
+            HLS_PROFILE_END_PPC(HLS_CROP_PPC_SECTION, image_width, image_height, HLS_PPC);
+            return;
+        }
+
+        hls_uint<16> crop_start_x = hls_register_section.reg_crop_start_x;
+        hls_uint<16> crop_end_x = hls_register_section.reg_crop_end_x;
+        hls_uint<16> crop_start_y = hls_register_section.reg_crop_start_y;
+        hls_uint<16> crop_end_y = hls_register_section.reg_crop_end_y;
+        hls_uint<16> crop_width = crop_end_x - crop_start_x + 1;
+        hls_uint<16> output_beats_per_row = (crop_width + HLS_PPC - 1) / HLS_PPC;
+        hls_uint<32> output_count = 0;
+        // 每行剩余 crop_width % HLS_PPC 个像素，非零时行尾多一拍flush
+        hls_uint<16> row_flush_num = (crop_width % HLS_PPC != 0) ? 1 : 0;
+
+        // 等待打包输出的像素，最多 HLS_PPC-1 个残留 + 一拍的 HLS_PPC 个新像素
+        hls_uint<HLS_OUTPUT_DATA_BITWIDTH> pending_lane[2 * HLS_PPC];
+        #pragma HLS ARRAY_PARTITION variable=pending_lane complete dim=1
+        hls_uint<8> pending_num = 0;
+
+        for (hls_uint<16> y_cnt = 0; y_cnt < image_height; y_cnt++) {
+            bool y_in_range = (y_cnt >= crop_start_y && y_cnt <= crop_end_y);
+            hls_uint<16> row_output_count = 0;
+            for (hls_uint<16> b_cnt = 0; b_cnt < beats_per_row + row_flush_num; b_cnt++) {
+                #pragma HLS PIPELINE II=1
+                HLS_PROFILE_LOOP("crop_ppc", 1);
+                bool row_flush = (b_cnt == beats_per_row);
+
+                if (!row_flush) {
+                    HLS_PROFILE_READ(input_stream);
+                    input_beat_t input_beat = input_stream.read();
+
+                    // 本拍落在裁剪窗口内的lane是连续的 [lane_lo, lane_hi]
+                    hls_uint<16> x_base = b_cnt * HLS_PPC;
+                    bool x_in_range = (crop_start_x < x_base + HLS_PPC) && (crop_end_x >= x_base);
+                    if (y_in_range && x_in_range) {
+                        hls_uint<16> lane_lo = (crop_start_x > x_base) ? hls_uint<16>(crop_start_x - x_base) : hls_uint<16>(0);
+                        hls_uint<16> lane_hi = (crop_end_x < x_base + HLS_PPC - 1) ? hls_uint<16>(crop_end_x - x_base) : hls_uint<16>(HLS_PPC - 1);
+                        for (int i = 0; i < HLS_PPC; i++) {
+                            #pragma HLS UNROLL
+                            if (i >= lane_lo && i <= lane_hi) {
+                                pending_lane[pending_num + i - lane_lo] = input_pack_t::get_lane(input_beat.data, i);
+                            }
+                        }
+                        pending_num += lane_hi - lane_lo + 1;
+                    }
+                }
+
+                // 凑满一拍就输出，行尾的flush拍输出剩余的部分拍
+                if (pending_num >= HLS_PPC || (row_flush && pending_num > 0)) {
+                    hls_uint<8> lane_num = (pending_num >= HLS_PPC) ? hls_uint<8>(HLS_PPC) : pending_num;
+                    output_beat_t output_beat;
+                    output_beat.data = 0;
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        if (i < lane_num) {
+                            output_pack_t::set_lane(output_beat.data, i, pending_lane[i]);
+                        }
+                        pending_lane[i] = pending_lane[i + HLS_PPC];
+                    }
+                    pending_num -= lane_num;
+                    output_count++;
+                    row_output_count++;
+                    output_beat.keep = output_pack_t::get_keep(lane_num);
+                    output_beat.strb = output_beat.keep;
+                    output_beat.user = (output_count == 1) ? 1 : 0;
+                    output_beat.last = (row_output_count == output_beats_per_row) ? 1 : 0;
+                    HLS_PROFILE_WRITE(output_stream);
+                    output_stream.write(output_beat);
+                }
+            }
+        }
+        HLS_PROFILE_END_PPC(HLS_CROP_PPC_SECTION, image_width, image_height, HLS_PPC);
+    }
+
+};
+
+
+#endif // HLS_CROP_PPC_H
@@ -0,0 +1,229 @@
+#ifndef HLS_CSIM_PROFILE_H
+#define HLS_CSIM_PROFILE_H
+
+// C-simulation cycle accounting for the HLS kernels, enabled with -DHLS_CSIM_PROFILE
+//  - every pipelined loop body calls HLS_PROFILE_LOOP(name, II), one iteration costs II cycles
+//  - stream accesses go through HLS_PROFILE_READ/WRITE, which also count the cycles where the
+//    hardware would stall (read on an empty stream, write on a full one)
+//  - HLS_PROFILE_END derives cycles/frame and pixels/clock for the frame size,
+//    HLS_PROFILE_END_PPC does the same for a kernel moving ppc pixels per beat
+//  - HLS_PROFILE_FIFO_TRACE(s) records the producer/consumer cycle of every beat through a
+//    dataflow FIFO, HLS_PROFILE_FIFO_REPORT(s, name) replays both kernels concurrently and
+//    reports the peak occupancy, i.e. the smallest depth that never stalls the producer
+// with HLS_THREADED_DATAFLOW the stall counters depend on the thread interleaving, the cycle
+// counts and the fifo report do not
+// the estimate ignores pipeline fill/flush and the dataflow overlap between kernels, it is meant
+// to catch II and trip-count regressions (padding iterations, II>1 loops) before synthesis
+// without the flag, and always under __SYNTHESIS__, the macros expand to nothing
+
+#if defined(HLS_CSIM_PROFILE) && !defined(__SYNTHESIS__)
+
+// std
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#ifdef HLS_THREADED_DATAFLOW
+#include <mutex>
+#endif
+
+// tool
+#include "print_function.h"
+
+// using
+using std::string;
+using std::map;
+using std::vector;
+
+
+// per FIFO: cycle of every write in the producer's clock, of every read in the consumer's clock
+struct HlsCsimFifoTrace {
+    vector<uint64_t> write_cycle;
+    vector<uint64_t> read_cycle;
+};
+
+inline map<const void*, HlsCsimFifoTrace>& hls_csim_fifo_trace_map() {
+    static map<const void*, HlsCsimFifoTrace> trace_map;
+    return trace_map;
+}
+
+inline void hls_csim_fifo_trace_event(const void* s, uint64_t cycle, bool is_write) {
+    map<const void*, HlsCsimFifoTrace>& trace_map = hls_csim_fifo_trace_map();
+    if (trace_map.empty()) {
+        return;
+    }
+    map<const void*, HlsCsimFifoTrace>::iterator it = trace_map.find(s);
+    if (it != trace_map.end()) {
+        (is_write ? it->second.write_cycle : it->second.read_cycle).push_back(cycle);
+    }
+}
+
+
+struct HlsCsimProfile {
+    map<string, uint64_t> loop_iterations;  // per pipelined loop
+    uint64_t cycle;                         // running cycle estimate
+    uint64_t stream_reads;
+    uint64_t stream_writes;
+    uint64_t read_stalls;                   // read issued while the input stream was empty
+    uint64_t write_stalls;                  // write issued while the output stream was full
+    int64_t first_read_cycle;               // -1 until the first read
+    int64_t first_write_cycle;              // -1 until the first write
+
+    // frame summary filled in by end()
+    uint64_t frame_pixels;
+    uint64_t frame_ideal_cycles;            // pixels / ppc, one beat per clock
+    uint64_t frame_cycles;
+    double pixels_per_clock;
+    int64_t first_output_latency;
+
+    HlsCsimProfile() { begin(); }
+
+    void begin() {
+        loop_iterations.clear();
+        cycle = 0;
+        stream_reads = 0;
+        stream_writes = 0;
+        read_stalls = 0;
+        write_stalls = 0;
+        first_read_cycle = -1;
+        first_write_cycle = -1;
+        frame_pixels = 0;
+        frame_ideal_cycles = 0;
+        frame_cycles = 0;
+        pixels_per_clock = 0;
+        first_output_latency = -1;
+    }
+
+    void loop(const char* name, int ii) {
+        loop_iterations[name]++;
+        cycle += ii;
+    }
+
+    template <typename S>
+    void read(S& s) {
+        if (s.empty()) {
+            read_stalls++;
+        }
+        if (first_read_cycle < 0) {
+            first_read_cycle = cycle;
+        }
+        stream_reads++;
+        hls_csim_fifo_trace_event(&s, cycle, false);
+    }
+
+    template <typename S>
+    void write(S& s) {
+        if (s.full()) {
+            write_stalls++;
+        }
+        if (first_write_cycle < 0) {
+            first_write_cycle = cycle;
+        }
+        stream_writes++;
+        hls_csim_fifo_trace_event(&s, cycle, true);
+    }
+
+    void end(const string& kernel_name, uint64_t width, uint64_t height, uint64_t ppc = 1) {
+        frame_pixels = width * height;
+        frame_ideal_cycles = ((width + ppc - 1) / ppc) * height;
+        frame_cycles = cycle + read_stalls + write_stalls;
+        pixels_per_clock = frame_cycles ? (double)frame_pixels / frame_cycles : 0;
+        first_output_latency = (first_read_cycle >= 0 && first_write_cycle >= 0) ? first_write_cycle - first_read_cycle : -1;
+        print(kernel_name);
+    }
+
+    void print(const string& kernel_name) const {
+        char line[256];
+        for (map<string, uint64_t>::const_iterator it = loop_iterations.begin(); it != loop_iterations.end(); ++it) {
+            snprintf(line, sizeof(line), "loop %-20s iterations: %llu (%.4f per pixel)", it->first.c_str(),
+                     (unsigned long long)it->second, frame_pixels ? (double)it->second / frame_pixels : 0.0);
+            main_info(kernel_name, line);
+        }
+        snprintf(line, sizeof(line), "stream reads: %llu, writes: %llu, read stalls: %llu, write stalls: %llu",
+                 (unsigned long long)stream_reads, (unsigned long long)stream_writes,
+                 (unsigned long long)read_stalls, (unsigned long long)write_stalls);
+        main_info(kernel_name, line);
+        snprintf(line, sizeof(line), "cycles/frame: %llu, pixels: %llu, overhead cycles: %lld, pixels/clock: %.4f, first output latency: %lld",
+                 (unsigned long long)frame_cycles, (unsigned long long)frame_pixels,
+                 (long long)frame_cycles - (long long)frame_ideal_cycles, pixels_per_clock, (long long)first_output_latency);
+        main_info(kernel_name, line);
+    }
+};
+
+// one profile per kernel name, kept until the next HLS_PROFILE_BEGIN of that kernel
+inline HlsCsimProfile& hls_csim_profile(const string& kernel_name) {
+    static map<string, HlsCsimProfile> profile_map;
+#ifdef HLS_THREADED_DATAFLOW
+    static std::mutex profile_mutex;
+    std::lock_guard<std::mutex> lock(profile_mutex);
+#endif
+    return profile_map[kernel_name];
+}
+
+// both kernels of a DATAFLOW region start at cycle 0, the producer never blocks (unbounded FIFO)
+// and the consumer's k-th read slips until one cycle after the k-th write
+// the peak of writes - reads over time is the depth needed to keep the producer stall free
+inline void hls_csim_fifo_report(const void* s, const string& fifo_name) {
+    map<const void*, HlsCsimFifoTrace>& trace_map = hls_csim_fifo_trace_map();
+    map<const void*, HlsCsimFifoTrace>::iterator it = trace_map.find(s);
+    if (it == trace_map.end()) {
+        return;
+    }
+    const vector<uint64_t>& write_cycle = it->second.write_cycle;
+    const vector<uint64_t>& read_cycle = it->second.read_cycle;
+    size_t beat_num = std::min(write_cycle.size(), read_cycle.size());
+
+    vector<uint64_t> read_time(beat_num);
+    uint64_t consumer_delay = 0;
+    for (size_t k = 0; k < beat_num; k++) {
+        uint64_t t = read_cycle[k] + consumer_delay;
+        if (t <= write_cycle[k]) {
+            t = write_cycle[k] + 1;
+            consumer_delay = t - read_cycle[k];
+        }
+        read_time[k] = t;
+    }
+
+    size_t peak_occupancy = 0;
+    size_t read_num = 0;
+    for (size_t k = 0; k < write_cycle.size(); k++) {
+        while (read_num < beat_num && read_time[read_num] <= write_cycle[k]) {
+            read_num++;
+        }
+        peak_occupancy = std::max(peak_occupancy, k + 1 - read_num);
+    }
+
+    char line[256];
+    snprintf(line, sizeof(line), "fifo %s: beats: %llu/%llu, peak occupancy: %llu, consumer stall cycles: %llu",
+             fifo_name.c_str(), (unsigned long long)write_cycle.size(), (unsigned long long)read_cycle.size(),
+             (unsigned long long)peak_occupancy, (unsigned long long)consumer_delay);
+    main_info("HlsCsimProfile", line);
+    trace_map.erase(it);
+}
+
+#define HLS_PROFILE_BEGIN(kernel)           HlsCsimProfile& hls_csim_profile_ref = hls_csim_profile(kernel); hls_csim_profile_ref.begin()
+#define HLS_PROFILE_LOOP(name, ii)          hls_csim_profile_ref.loop(name, ii)
+#define HLS_PROFILE_READ(s)                 hls_csim_profile_ref.read(s)
+#define HLS_PROFILE_WRITE(s)                hls_csim_profile_ref.write(s)
+#define HLS_PROFILE_END(kernel, w, h)       hls_csim_profile_ref.end(kernel, w, h)
+#define HLS_PROFILE_END_PPC(kernel, w, h, ppc)  hls_csim_profile_ref.end(kernel, w, h, ppc)
+#define HLS_PROFILE_FIFO_TRACE(s)           hls_csim_fifo_trace_map()[&(s)] = HlsCsimFifoTrace()
+#define HLS_PROFILE_FIFO_REPORT(s, name)    hls_csim_fifo_report(&(s), name)
+
+#else
+
+#define HLS_PROFILE_BEGIN(kernel)
+#define HLS_PROFILE_LOOP(name, ii)
+#define HLS_PROFILE_READ(s)
+#define HLS_PROFILE_WRITE(s)
+#define HLS_PROFILE_END(kernel, w, h)
+#define HLS_PROFILE_END_PPC(kernel, w, h, ppc)
+#define HLS_PROFILE_FIFO_TRACE(s)
+#define HLS_PROFILE_FIFO_REPORT(s, name)
+
+#endif
+
+
+#endif // HLS_CSIM_PROFILE_H
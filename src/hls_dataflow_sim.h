@@ -0,0 +1,175 @@
+#ifndef HLS_DATAFLOW_SIM_H
+#define HLS_DATAFLOW_SIM_H
+
+// C-simulation only threaded runtime for DATAFLOW regions, selected with -DHLS_THREADED_DATAFLOW
+// (on top of -DHLS_FAST_STREAM_SIM, link with -pthread)
+//  - every HLS_DATAFLOW_PROCESS of a region runs in its own thread, started together by HLS_DATAFLOW_END
+//  - hls_sim::stream blocks a process on read while empty and on write while full (set_depth),
+//    so intermediate FIFOs hold depth beats instead of a whole frame
+//  - a watchdog reports a deadlock when every running process has been blocked on a stream for a
+//    whole HLS_DATAFLOW_WATCHDOG_MS interval, listing who waits on what (e.g. a FIFO too shallow)
+// only one region runs at a time, processes must not start nested regions
+
+#ifdef __SYNTHESIS__
+#error "hls_dataflow_sim.h is a C-simulation model and must not be synthesized"
+#endif
+
+// std
+#include <vector>
+#include <map>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <chrono>
+
+// tool
+#include "print_function.h"
+
+// using
+using std::string;
+
+// def
+#define HLS_DATAFLOW_SIM_SECTION    "HlsDataflowSim"
+#ifndef HLS_DATAFLOW_WATCHDOG_MS
+#define HLS_DATAFLOW_WATCHDOG_MS    200
+#endif
+
+
+namespace hls_sim {
+
+// process bookkeeping shared by the region, the streams and the watchdog
+class dataflow_scheduler {
+public:
+    static dataflow_scheduler& instance() {
+        static dataflow_scheduler scheduler;
+        return scheduler;
+    }
+
+    // name of the process running on this thread, empty outside a region (testbench)
+    static string& current_process() {
+        static thread_local string process_name;
+        return process_name;
+    }
+
+    static bool in_process() { return !current_process().empty(); }
+
+    void start(size_t process_num) {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        if (running_num > 0) {
+            main_error(HLS_DATAFLOW_SIM_SECTION, "nested or concurrent dataflow regions are not supported");
+        }
+        running_num = process_num;
+        blocked_num = 0;
+        event_num = 0;
+        wait_map.clear();
+    }
+
+    void finish() {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        running_num--;
+        event_num++;
+    }
+
+    // called by a stream right before / after its process waits
+    void block(const string& stream_name, const char* op) {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        blocked_num++;
+        event_num++;
+        wait_map[current_process()] = string(op) + " '" + stream_name + "'";
+    }
+
+    void unblock() {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        blocked_num--;
+        event_num++;
+        wait_map.erase(current_process());
+    }
+
+    // all running processes blocked and nobody woke up since the last check
+    bool check_deadlock(size_t& last_event_num, bool& last_all_blocked) {
+        std::lock_guard<std::mutex> lock(scheduler_mutex);
+        bool all_blocked = running_num > 0 && blocked_num == running_num;
+        bool deadlock = all_blocked && last_all_blocked && event_num == last_event_num;
+        last_all_blocked = all_blocked;
+        last_event_num = event_num;
+        if (deadlock) {
+            for (std::map<string, string>::const_iterator it = wait_map.begin(); it != wait_map.end(); ++it) {
+                main_info(HLS_DATAFLOW_SIM_SECTION, "process '" + it->first + "' blocked on " + it->second);
+            }
+        }
+        return deadlock;
+    }
+
+private:
+    dataflow_scheduler() : running_num(0), blocked_num(0), event_num(0) {}
+
+    std::mutex scheduler_mutex;
+    size_t running_num;
+    size_t blocked_num;
+    size_t event_num;
+    std::map<string, string> wait_map;      // process -> stream it waits on
+};
+
+
+// processes are collected by process() and run concurrently by run(), which returns when all finished
+class dataflow_region {
+public:
+    explicit dataflow_region(const char* name) : region_name(name) {}
+
+    void process(const char* name, const std::function<void()>& body) {
+        process_name_list.push_back(region_name + "/" + name);
+        process_list.push_back(body);
+    }
+
+    void run() {
+        dataflow_scheduler& scheduler = dataflow_scheduler::instance();
+        scheduler.start(process_list.size());
+
+        std::vector<std::thread> thread_list;
+        for (size_t i = 0; i < process_list.size(); i++) {
+            thread_list.push_back(std::thread([this, &scheduler, i]() {
+                dataflow_scheduler::current_process() = process_name_list[i];
+                process_list[i]();
+                dataflow_scheduler::current_process().clear();
+                scheduler.finish();
+            }));
+        }
+
+        // watchdog, wakes up early once every process has finished
+        std::mutex watchdog_mutex;
+        std::condition_variable watchdog_cv;
+        bool done = false;
+        std::thread watchdog([&]() {
+            size_t last_event_num = 0;
+            bool last_all_blocked = false;
+            std::unique_lock<std::mutex> lock(watchdog_mutex);
+            while (!watchdog_cv.wait_for(lock, std::chrono::milliseconds(HLS_DATAFLOW_WATCHDOG_MS), [&]() { return done; })) {
+                if (scheduler.check_deadlock(last_event_num, last_all_blocked)) {
+                    main_error(HLS_DATAFLOW_SIM_SECTION, "region '" + region_name + "' deadlocked, every process is blocked on a stream");
+                }
+            }
+        });
+
+        for (size_t i = 0; i < thread_list.size(); i++) {
+            thread_list[i].join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex);
+            done = true;
+        }
+        watchdog_cv.notify_one();
+        watchdog.join();
+    }
+
+private:
+    string region_name;
+    std::vector<string> process_name_list;
+    std::vector<std::function<void()>> process_list;
+};
+
+} // namespace hls_sim
+
+
+#endif // HLS_DATAFLOW_SIM_H
@@ -1,43 +1,288 @@
-// #ifndef HLS_DPC_H
-// #define HLS_DPC_H
-
-// #include <ap_int.h>
-// #include <hls_stream.h>
-// #include "ap_axi_sdata.h"
-// #include "hls_crop.h"
-
-// #define HLS_DPC_LINEBUFFER_DEPTH 1024
-
-// // HLS DPC寄存器信息结构体
-// struct HlsDpcRegisterInfo {
-//     ap_uint<16> image_width;
-//     ap_uint<16> image_height;
-//     ap_uint<1>  dpc_enable;
-//     ap_uint<16> dpc_threshold;
-// };
-
-// // HLS DPC类
-// class HlsDpc {
-// private:
-//     // 行缓冲区定义 - 使用与hls_crop.h中一致的类型
-//     static ap_uint<DATA_WIDTH*2> hls_dpc_linebuffer[4][(HLS_DPC_LINEBUFFER_DEPTH+1)/2];
-    
-//     // 辅助函数：裁剪值到指定范围
-//     ap_uint<16> clip(ap_uint<16> value, ap_uint<16> min, ap_uint<16> max);
-    
-//     // 内部DPC处理函数
-//     void ProcessDpc(ap_uint<DATA_WIDTH>* pixel_window, ap_uint<DATA_WIDTH>& pixel_out, const HlsDpcRegisterInfo& regs);
-    
-// public:
-//     HlsDpc() {};
-//     ~HlsDpc() {};
-    
-//     // DPC处理函数
-//     void Process(
-//         hls::stream<axis_pixel_t>& input_stream,
-//         hls::stream<axis_pixel_t>& output_stream,
-//         const HlsDpcRegisterInfo& regs
-//     );
-// };
-
-// #endif
\ No newline at end of file
+#ifndef HLS_DPC_H
+#define HLS_DPC_H
+
+// std
+#include <ap_int.h>
+#include <hls_stream.h>
+#include "ap_axi_sdata.h"
+
+// using
+using std::string;
+
+// ip
+#include "hls_info.h"
+#include "hls_csim_profile.h"
+#include "hls_axis_pack.h"
+#include "hls_linebuffer.h"
+
+// def
+#define HLS_DPC_SECTION             "HlsDpc"
+#define HLS_DPC_MAX_WIDTH           4096    // default max image width in pixels, up to HLS_LINEBUFFER_MAX_WIDTH
+
+
+// streaming DPC with HLS_PPC pixels per clock (1/2/4), bit-exact with AlgDpc::process_image
+//  - HlsAxisPack beats as HlsCropPpc: lane i = pixel beat*HLS_PPC + i, every row starts on a new
+//    beat, user marks the first beat of the frame (SOF), last the final beat of every row (EOL)
+//  - a 4 row HlsLineBuffer of packed beats holds the last rows while row r streams in,
+//    output row r-2 and output beat b-HLS_DPC_LAG are produced in the same iteration
+//  - HLS_MAX_WIDTH sizes the line buffer (up to 8192), reg_image_width may be anything up to it
+//  - the 5x5 neighbourhood is clamped to the image (get_mirrored_pixel) by replicating the edge
+//    pixels before they enter a shift-register window of 2*HLS_DPC_LAG+1 beats, driven by a small
+//    edge state (oldest valid row, first/last beat of the row, last pixel of the row), so every
+//    tap is a fixed window column and no index is computed per pixel
+//  - adjacent output pixels of a beat share that window and are evaluated in parallel
+// trip count is (height+2) * (beats_per_row+HLS_DPC_LAG), the extra rows/beats drain the window
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC = 1, int HLS_MAX_WIDTH = HLS_DPC_MAX_WIDTH>
+class HlsDpc {
+public:
+    typedef HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC> input_pack_t;
+    typedef HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC> output_pack_t;
+    typedef typename input_pack_t::beat_t input_beat_t;
+    typedef typename output_pack_t::beat_t output_beat_t;
+    typedef HlsLineBuffer<HLS_INPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH, 4> linebuffer_t;
+
+    static const int HLS_DPC_LAG = (2 + HLS_PPC - 1) / HLS_PPC;                 // beats covering 2 pixel columns
+    static const int HLS_DPC_WINDOW = (2 * HLS_DPC_LAG + 1) * HLS_PPC;          // pixel columns in the window
+
+    HlsDpc() {};
+    ~HlsDpc() {};
+
+    void run(
+        hls_stream_t<input_beat_t>& input_stream,
+        hls_stream_t<output_beat_t>& output_stream,
+        const HlsRegisterSection& hls_register_section
+    ) {
+        #pragma HLS INTERFACE axis port=input_stream
+        #pragma HLS INTERFACE axis port=output_stream
+        #pragma HLS INTERFACE s_axilite port=hls_register_section bundle=control
+        #pragma HLS INTERFACE s_axilite port=return bundle=control
+
+        HLS_PROFILE_BEGIN(HLS_DPC_SECTION);
+
+        hls_uint<16> image_width = hls_register_section.reg_image_width;
+        hls_uint<16> image_height = hls_register_section.reg_image_height;
+        hls_uint<16> beats_per_row = (image_width + HLS_PPC - 1) / HLS_PPC;
+        hls_uint<16> last_beat_cnt = beats_per_row - 1;
+        hls_uint<16> last_lane_num = image_width - last_beat_cnt * HLS_PPC;   // 每行最后一拍的有效像素数
+#ifndef __SYNTHESIS__
+        if (hls_register_section.reg_dpc_enable && image_width > HLS_MAX_WIDTH) {
+            main_error(HLS_DPC_SECTION, "reg_image_width " + std::to_string((int)image_width) + " exceeds the line buffer max width " + std::to_string(HLS_MAX_WIDTH));
+        }
+#endif
+
+        // 如果DPC未启用，直接透传数据
+        if (!hls_register_section.reg_dpc_enable) {
+            for (hls_uint<16> y_cnt = 0; y_cnt < image_height; y_cnt++) {
+                for (hls_uint<16> b_cnt = 0; b_cnt < beats_per_row; b_cnt++) {
+                    #pragma HLS PIPELINE II=1
+                    HLS_PROFILE_LOOP("dpc_bypass", 1);
+                    HLS_PROFILE_READ(input_stream);
+                    input_beat_t input_beat = input_stream.read();
+                    output_beat_t output_beat;
+                    output_beat.data = 0;
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        output_pack_t::set_lane(output_beat.data, i, input_pack_t::get_lane(input_beat.data, i));
+                    }
+                    output_beat.keep = output_pack_t::get_keep((b_cnt == last_beat_cnt) ? last_lane_num : hls_uint<16>(HLS_PPC));
+                    output_beat.strb = output_beat.keep;
+                    output_beat.user = (y_cnt == 0 && b_cnt == 0) ? 1 : 0;
+                    output_beat.last = (b_cnt == last_beat_cnt) ? 1 : 0;
+                    HLS_PROFILE_WRITE(output_stream);
+                    output_stream.write(output_beat);
+                }
+            }
+            HLS_PROFILE_END_PPC(HLS_DPC_SECTION, image_width, image_height, HLS_PPC);
+            return;
+        }
+
+        // 5行 x (2*LAG+1)拍 的像素窗口，第j列对应像素列 (b_cnt - 2*LAG)*HLS_PPC + j
+        // 进入窗口的像素已经做了边界复制，输出像素的5x5邻域是窗口中固定的列
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> pixel_window[5][HLS_DPC_WINDOW];
+        #pragma HLS ARRAY_PARTITION variable=pixel_window complete dim=0
+
+        // 边界状态机
+        //  - 顶部: oldest_slot 为 history 中最早的有效行，之前的行复制该行，每行结束时饱和递增
+        //  - 底部: 输入行读完后重复存入最后一行，history 始终是 r-1..r-4 行
+        //  - 左侧: 每行第一拍把整个窗口填成该行第0个像素
+        //  - 右侧: 最后一拍的无效lane和排空拍复制 edge_pixel (该行最后一个有效像素)
+        hls_uint<2> oldest_slot = 0;
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> edge_pixel[5];
+        #pragma HLS ARRAY_PARTITION variable=edge_pixel complete dim=0
+
+        for (hls_uint<16> r_cnt = 0; r_cnt < image_height + 2; r_cnt++) {
+            for (hls_uint<16> b_cnt = 0; b_cnt < beats_per_row + HLS_DPC_LAG; b_cnt++) {
+                #pragma HLS PIPELINE II=1
+                HLS_PROFILE_LOOP("dpc", 1);
+
+                bool row_beat = (b_cnt < beats_per_row);
+                bool last_beat = (b_cnt == last_beat_cnt);
+
+                // --- 输入列: 行 r-4..r 的第 b_cnt 拍，column[4] 为第r行 ---
+                hls_uint<HLS_INPUT_DATA_BITWIDTH * HLS_PPC> column[5];
+                if (row_beat) {
+                    // 先读后写，history[k] 为第 r-1-k 行
+                    hls_uint<HLS_INPUT_DATA_BITWIDTH * HLS_PPC> history[4];
+                    hls_dpc_linebuffer.read(b_cnt, history);
+                    hls_uint<HLS_INPUT_DATA_BITWIDTH * HLS_PPC> newest;
+                    if (r_cnt < image_height) {
+                        HLS_PROFILE_READ(input_stream);
+                        input_beat_t input_beat = input_stream.read();
+                        newest = input_beat.data;
+                    } else {
+                        newest = history[0];
+                    }
+                    hls_dpc_linebuffer.shift_in(b_cnt, history, newest);
+                    column[4] = newest;
+                    for (int k = 0; k < 4; k++) {
+                        #pragma HLS UNROLL
+                        column[3 - k] = (k <= oldest_slot) ? history[k] : history[oldest_slot];
+                    }
+                } else {
+                    // 行尾排空，新列全部取 edge_pixel
+                    for (int k = 0; k < 5; k++) {
+                        #pragma HLS UNROLL
+                        column[k] = 0;
+                    }
+                }
+
+                // 左右边界复制后的新像素
+                hls_uint<HLS_INPUT_DATA_BITWIDTH> new_pixel[5][HLS_PPC];
+                for (int k = 0; k < 5; k++) {
+                    #pragma HLS UNROLL
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        if (!row_beat) {
+                            new_pixel[k][i] = edge_pixel[k];
+                        } else if (i > 0 && last_beat && i >= last_lane_num) {
+                            new_pixel[k][i] = new_pixel[k][i - 1];
+                        } else {
+                            new_pixel[k][i] = hls_uint<HLS_INPUT_DATA_BITWIDTH>(column[k].range((i + 1) * HLS_INPUT_DATA_BITWIDTH - 1, i * HLS_INPUT_DATA_BITWIDTH));
+                        }
+                    }
+                    edge_pixel[k] = new_pixel[k][HLS_PPC - 1];
+                }
+
+                // 窗口左移一拍，新列从右侧进入
+                for (int k = 0; k < 5; k++) {
+                    #pragma HLS UNROLL
+                    for (int j = 0; j < HLS_DPC_WINDOW - HLS_PPC; j++) {
+                        #pragma HLS UNROLL
+                        pixel_window[k][j] = (row_beat && b_cnt == 0) ? new_pixel[k][0] : pixel_window[k][j + HLS_PPC];
+                    }
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        pixel_window[k][HLS_DPC_WINDOW - HLS_PPC + i] = new_pixel[k][i];
+                    }
+                }
+
+                // --- 输出: 第 r-2 行的第 b_cnt-LAG 拍 ---
+                if (r_cnt >= 2 && b_cnt >= HLS_DPC_LAG) {
+                    hls_uint<16> lane_num = (b_cnt == last_beat_cnt + HLS_DPC_LAG) ? last_lane_num : hls_uint<16>(HLS_PPC);
+                    output_beat_t output_beat;
+                    output_beat.data = 0;
+                    for (int i = 0; i < HLS_PPC; i++) {
+                        #pragma HLS UNROLL
+                        // lane i 的中心像素在窗口第 LAG*HLS_PPC+i 列
+                        hls_uint<HLS_INPUT_DATA_BITWIDTH> pixel_5x5[5][5];
+                        for (int dx = 0; dx < 5; dx++) {
+                            #pragma HLS UNROLL
+                            for (int k = 0; k < 5; k++) {
+                                #pragma HLS UNROLL
+                                pixel_5x5[k][dx] = pixel_window[k][HLS_DPC_LAG * HLS_PPC + i - 2 + dx];
+                            }
+                        }
+                        if (i < lane_num) {
+                            output_pack_t::set_lane(output_beat.data, i, process_pixel(pixel_5x5, hls_register_section.reg_dpc_threshold));
+                        }
+                    }
+                    output_beat.keep = output_pack_t::get_keep(lane_num);
+                    output_beat.strb = output_beat.keep;
+                    output_beat.user = (r_cnt == 2 && b_cnt == HLS_DPC_LAG) ? 1 : 0;
+                    output_beat.last = (b_cnt == last_beat_cnt + HLS_DPC_LAG) ? 1 : 0;
+                    HLS_PROFILE_WRITE(output_stream);
+                    output_stream.write(output_beat);
+                }
+            }
+            if (r_cnt > 0 && oldest_slot < 3) {
+                oldest_slot++;
+            }
+        }
+        HLS_PROFILE_END_PPC(HLS_DPC_SECTION, image_width, image_height, HLS_PPC);
+    }
+
+#ifndef __SYNTHESIS__
+    // line buffer memory of this configuration, to trade max width against the BRAM budget
+    static void report_memory() {
+        linebuffer_t::report(HLS_DPC_SECTION);
+    }
+#endif
+
+private:
+    linebuffer_t hls_dpc_linebuffer;
+
+    static hls_uint<HLS_INPUT_DATA_BITWIDTH + 2> abs_diff(hls_int<HLS_INPUT_DATA_BITWIDTH + 3> value) {
+        return (value < 0) ? hls_int<HLS_INPUT_DATA_BITWIDTH + 3>(-value) : value;
+    }
+
+    // 与 AlgDpc 相同的判定和校正，p[2][2] 为中心像素，p[dy+2][dx+2]
+    static hls_uint<HLS_OUTPUT_DATA_BITWIDTH> process_pixel(hls_uint<HLS_INPUT_DATA_BITWIDTH> p[5][5], hls_uint<16> threshold) {
+        #pragma HLS INLINE
+        typedef hls_int<HLS_INPUT_DATA_BITWIDTH + 3> grad_t;
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> p0 = p[2][2];
+
+        // 条件1: 中心像素在距离2的8个同色邻域的 [min, max] 之外
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> neighbor_2[8] = {
+            p[0][0], p[0][2], p[0][4],
+            p[2][0],          p[2][4],
+            p[4][0], p[4][2], p[4][4]
+        };
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> min_neighbor = neighbor_2[0];
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> max_neighbor = neighbor_2[0];
+        for (int i = 1; i < 8; i++) {
+            #pragma HLS UNROLL
+            min_neighbor = (neighbor_2[i] < min_neighbor) ? neighbor_2[i] : min_neighbor;
+            max_neighbor = (neighbor_2[i] > max_neighbor) ? neighbor_2[i] : max_neighbor;
+        }
+        bool cond1_met = (p0 < min_neighbor) || (p0 > max_neighbor);
+
+        // 条件2: 与3x3邻域8个像素的差的绝对值都大于阈值
+        hls_uint<HLS_INPUT_DATA_BITWIDTH> neighbor_1[8] = {
+            p[1][1], p[1][2], p[1][3],
+            p[2][1],          p[2][3],
+            p[3][1], p[3][2], p[3][3]
+        };
+        bool cond2_met = true;
+        for (int i = 0; i < 8; i++) {
+            #pragma HLS UNROLL
+            if (abs_diff(grad_t(p0) - grad_t(neighbor_1[i])) <= threshold) {
+                cond2_met = false;
+            }
+        }
+
+        hls_uint<HLS_OUTPUT_DATA_BITWIDTH> pixel_out = p0;
+        if (cond1_met && cond2_met) {
+            hls_uint<HLS_INPUT_DATA_BITWIDTH + 2> dv  = abs_diff(2 * grad_t(p0) - p[0][2] - p[4][2]);
+            hls_uint<HLS_INPUT_DATA_BITWIDTH + 2> dh  = abs_diff(2 * grad_t(p0) - p[2][0] - p[2][4]);
+            hls_uint<HLS_INPUT_DATA_BITWIDTH + 2> ddl = abs_diff(2 * grad_t(p0) - p[0][0] - p[4][4]);
+            hls_uint<HLS_INPUT_DATA_BITWIDTH + 2> ddr = abs_diff(2 * grad_t(p0) - p[0][4] - p[4][0]);
+
+            // 最小梯度方向插值，相等时优先级 dv > dh > ddl > ddr (与AlgDpc一致)
+            hls_uint<HLS_INPUT_DATA_BITWIDTH + 1> sum;
+            if (dv <= dh && dv <= ddl && dv <= ddr) {
+                sum = hls_uint<HLS_INPUT_DATA_BITWIDTH + 1>(p[1][2]) + p[3][2];
+            } else if (dh <= ddl && dh <= ddr) {
+                sum = hls_uint<HLS_INPUT_DATA_BITWIDTH + 1>(p[2][1]) + p[2][3];
+            } else if (ddl <= ddr) {
+                sum = hls_uint<HLS_INPUT_DATA_BITWIDTH + 1>(p[1][1]) + p[3][3];
+            } else {
+                sum = hls_uint<HLS_INPUT_DATA_BITWIDTH + 1>(p[1][3]) + p[3][1];
+            }
+            pixel_out = sum >> 1;
+        }
+        return pixel_out;
+    }
+};
+
+
+#endif // HLS_DPC_H
@@ -0,0 +1,162 @@
+#ifndef HLS_FAST_INT_H
+#define HLS_FAST_INT_H
+
+// C-simulation only native-backed replacement for ap_uint/ap_int of up to 64 bits, selected with
+// -DHLS_FAST_INT_SIM through the hls_uint<W>/hls_int<W> aliases of hls_info.h
+//  - the value lives in one uint64_t/int64_t, always truncated (unsigned) or sign extended (signed)
+//    to W bits, so assignment has the ap_[u]int wrap semantics
+//  - arithmetic, comparison and the bitwise & | ^ go through the implicit conversion to int64_t,
+//    i.e. they are evaluated at full precision like the widened ap_int results, and the
+//    assignment back to hls_uint<W>/hls_int<W> truncates
+//  - ~, << and >> keep width and signedness (as ap_int_base does), .range(hi, lo) and [i] are proxies
+// exact as long as intermediates fit in 64 bits (the kernels use at most 32 bit products), an
+// unsigned 64 bit value converts to uint64_t so its arithmetic wraps modulo 2^64
+// the hls_info.h aliases only select it up to 63 bits, fast_int<64, true> / -1 traps on INT64_MIN
+// hls_fast_int_check_main is the differential check against ap_int
+
+#ifdef __SYNTHESIS__
+#error "hls_fast_int.h is a C-simulation model and must not be synthesized"
+#endif
+
+// std
+#include <cstdint>
+#include <iostream>
+
+
+namespace hls_fast {
+
+// conversion type: int64_t unless an unsigned 64 bit value would not fit
+template <int W, bool S>
+struct native_type { typedef int64_t type; };
+template <>
+struct native_type<64, false> { typedef uint64_t type; };
+
+template <int W, bool S>
+class fast_int {
+public:
+    static_assert(W >= 1 && W <= 64, "hls_fast::fast_int supports 1 to 64 bits");
+    typedef typename native_type<W, S>::type native_t;
+
+    fast_int() : value(0) {}
+    // any integer, fast_int or ap_[u]int / range / bit proxy, truncated to W bits
+    template <typename A>
+    fast_int(const A& a) : value(normalize(static_cast<uint64_t>(a))) {}
+    fast_int(const fast_int& other) : value(other.value) {}
+
+    fast_int& operator=(const fast_int& other) { value = other.value; return *this; }
+
+    operator native_t() const { return static_cast<native_t>(value); }
+
+    // ap_int_base style accessors
+    int to_int() const { return static_cast<int>(value); }
+    unsigned to_uint() const { return static_cast<unsigned>(value); }
+    int64_t to_int64() const { return static_cast<int64_t>(value); }
+    uint64_t to_uint64() const { return value; }
+    bool to_bool() const { return value != 0; }
+    static int length() { return W; }
+
+    // width and signedness preserving operators
+    fast_int operator~() const { return fast_int(~value); }
+    fast_int operator<<(int n) const { return fast_int(n >= 64 ? 0 : value << n); }
+    fast_int operator>>(int n) const {
+        if (S) {
+            return fast_int(static_cast<uint64_t>(static_cast<int64_t>(value) >> (n >= 64 ? 63 : n)));
+        }
+        return fast_int(n >= 64 ? 0 : value >> n);
+    }
+
+    // compound assignment, truncated to W bits: + - * wrap in uint64_t (only the W low bits survive,
+    // and an int64_t overflow would be undefined), / and % are evaluated at full precision
+    template <typename A> fast_int& operator+=(const A& a) { value = normalize(value + static_cast<uint64_t>(a)); return *this; }
+    template <typename A> fast_int& operator-=(const A& a) { value = normalize(value - static_cast<uint64_t>(a)); return *this; }
+    template <typename A> fast_int& operator*=(const A& a) { value = normalize(value * static_cast<uint64_t>(a)); return *this; }
+    template <typename A> fast_int& operator/=(const A& a) { return *this = native_t(*this) / a; }
+    template <typename A> fast_int& operator%=(const A& a) { return *this = native_t(*this) % a; }
+    template <typename A> fast_int& operator&=(const A& a) { return *this = native_t(*this) & a; }
+    template <typename A> fast_int& operator|=(const A& a) { return *this = native_t(*this) | a; }
+    template <typename A> fast_int& operator^=(const A& a) { return *this = native_t(*this) ^ a; }
+    fast_int& operator<<=(int n) { return *this = *this << n; }
+    fast_int& operator>>=(int n) { return *this = *this >> n; }
+
+    fast_int& operator++() { value = normalize(value + 1); return *this; }
+    fast_int& operator--() { value = normalize(value - 1); return *this; }
+    fast_int operator++(int) { fast_int old = *this; ++*this; return old; }
+    fast_int operator--(int) { fast_int old = *this; --*this; return old; }
+
+    // bits [hi, lo], reads as unsigned
+    class range_ref {
+    public:
+        range_ref(fast_int* parent, int hi, int lo) : parent(parent), mask(bit_mask(hi - lo + 1)), lo(lo) {}
+        operator int64_t() const { return static_cast<int64_t>(get()); }
+        uint64_t to_uint64() const { return get(); }
+        int to_int() const { return static_cast<int>(get()); }
+        unsigned to_uint() const { return static_cast<unsigned>(get()); }
+        template <typename A>
+        range_ref& operator=(const A& a) {
+            uint64_t bits = (static_cast<uint64_t>(a) & mask) << lo;
+            parent->value = normalize((parent->value & ~(mask << lo)) | bits);
+            return *this;
+        }
+        range_ref& operator=(const range_ref& other) { return *this = other.get(); }
+    private:
+        uint64_t get() const { return (parent->value >> lo) & mask; }
+        fast_int* parent;
+        uint64_t mask;
+        int lo;
+    };
+
+    class bit_ref {
+    public:
+        bit_ref(fast_int* parent, int index) : parent(parent), index(index) {}
+        operator bool() const { return (parent->value >> index) & 1; }
+        bit_ref& operator=(bool bit) {
+            uint64_t cleared = parent->value & ~(uint64_t(1) << index);
+            parent->value = normalize(cleared | (uint64_t(bit) << index));
+            return *this;
+        }
+        bit_ref& operator=(const bit_ref& other) { return *this = bool(other); }
+    private:
+        fast_int* parent;
+        int index;
+    };
+
+    range_ref range(int hi, int lo) { return range_ref(this, hi, lo); }
+    uint64_t range(int hi, int lo) const { return (value >> lo) & bit_mask(hi - lo + 1); }
+    range_ref operator()(int hi, int lo) { return range(hi, lo); }
+    uint64_t operator()(int hi, int lo) const { return range(hi, lo); }
+    bit_ref operator[](int index) { return bit_ref(this, index); }
+    bool operator[](int index) const { return (value >> index) & 1; }
+
+    // {this, other}, unsigned of W + W2 bits
+    template <int W2, bool S2>
+    fast_int<W + W2, false> concat(const fast_int<W2, S2>& other) const {
+        return fast_int<W + W2, false>(((value & bit_mask(W)) << (W2 % 64)) | (other.to_uint64() & bit_mask(W2)));
+    }
+
+private:
+    static uint64_t bit_mask(int n) { return n >= 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1; }
+
+    // unsigned: W low bits, signed: W low bits sign extended to 64
+    static uint64_t normalize(uint64_t bits) {
+        if (W == 64) {
+            return bits;
+        }
+        bits &= bit_mask(W);
+        if (S && ((bits >> (W - 1)) & 1)) {
+            bits |= ~bit_mask(W);
+        }
+        return bits;
+    }
+
+    uint64_t value;
+};
+
+template <int W, bool S>
+std::ostream& operator<<(std::ostream& os, const fast_int<W, S>& a) {
+    return os << typename fast_int<W, S>::native_t(a);
+}
+
+} // namespace hls_fast
+
+
+#endif // HLS_FAST_INT_H
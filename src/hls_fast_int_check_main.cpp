@@ -0,0 +1,190 @@
+// std
+#include <iostream>
+#include <random>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+
+// ip
+#include <ap_int.h>
+#include "hls_fast_int.h"
+
+// def
+#define HLS_FAST_INT_CHECK_MAIN_SECTION "hls_fast_int_check_main"
+#define HLS_FAST_INT_CHECK_MAX_REPORT   10      // mismatches printed per width
+
+// using
+using namespace std;
+
+
+// differential check of hls_fast::fast_int<W, S> against ap_uint<W>/ap_int<W>
+// every result is assigned back to the W bit type and compared bit for bit (to_uint64)
+struct FastIntCheck {
+    mt19937_64& gen;
+    int width;
+    uint64_t check_num;
+    uint64_t fail_num;
+
+    FastIntCheck(mt19937_64& gen, int width) : gen(gen), width(width), check_num(0), fail_num(0) {}
+
+    void check(const char* op, bool is_signed, uint64_t ap_bits, uint64_t fast_bits, int64_t a, int64_t b) {
+        check_num++;
+        if (ap_bits != fast_bits) {
+            fail_num++;
+            if (fail_num <= HLS_FAST_INT_CHECK_MAX_REPORT) {
+                MAIN_INFO_1("w=" + to_string(width) + (is_signed ? " int " : " uint ") + op + " FAIL: a=" + to_string(a)
+                            + " b=" + to_string(b) + " ap=" + to_string(ap_bits) + " fast=" + to_string(fast_bits));
+            }
+        }
+    }
+
+    // full range, around 0 and around the wrap points
+    int64_t random_value() {
+        uint64_t bits = gen();
+        switch (gen() % 4) {
+        case 0: return (int64_t)(bits % 5) - 2;
+        case 1: return (int64_t)((uint64_t(1) << (width - 1)) + bits % 5 - 2);
+        case 2: return (int64_t)((width >= 64 ? 0 : (uint64_t(1) << width)) + bits % 5 - 2);
+        default: return (int64_t)bits;
+        }
+    }
+};
+
+
+// the operations the kernels use, for one signedness
+template <int W, bool S, typename AP>
+void check_ops(FastIntCheck& c, int64_t a_raw, int64_t b_raw) {
+    typedef hls_fast::fast_int<W, S> FAST;
+    AP a = a_raw, b = b_raw;
+    FAST fa = a_raw, fb = b_raw;
+    int shift = (int)(c.gen() % W);
+    int lo = (int)(c.gen() % W);
+    int hi = lo + (int)(c.gen() % (W - lo));
+
+    c.check("assign", S, AP(a).to_uint64(), FAST(fa).to_uint64(), a_raw, b_raw);
+    c.check("+", S, AP(a + b).to_uint64(), FAST(fa + fb).to_uint64(), a_raw, b_raw);
+    c.check("-", S, AP(a - b).to_uint64(), FAST(fa - fb).to_uint64(), a_raw, b_raw);
+    if (W <= 32) {
+        c.check("*", S, AP(a * b).to_uint64(), FAST(fa * fb).to_uint64(), a_raw, b_raw);
+    }
+    // INT64_MIN / -1 overflows a 64 bit native division (SIGFPE on x86), the pair is skipped at W = 64
+    if (b != 0 && !(W == 64 && a_raw == INT64_MIN && b_raw == -1)) {
+        c.check("/", S, AP(a / b).to_uint64(), FAST(fa / fb).to_uint64(), a_raw, b_raw);
+        c.check("%", S, AP(a % b).to_uint64(), FAST(fa % fb).to_uint64(), a_raw, b_raw);
+    }
+    c.check("&", S, AP(a & b).to_uint64(), FAST(fa & fb).to_uint64(), a_raw, b_raw);
+    c.check("|", S, AP(a | b).to_uint64(), FAST(fa | fb).to_uint64(), a_raw, b_raw);
+    c.check("^", S, AP(a ^ b).to_uint64(), FAST(fa ^ fb).to_uint64(), a_raw, b_raw);
+    c.check("~", S, AP(~a).to_uint64(), FAST(~fa).to_uint64(), a_raw, b_raw);
+    c.check("-a", S, AP(-a).to_uint64(), FAST(-fa).to_uint64(), a_raw, b_raw);
+    c.check("<<", S, AP(a << shift).to_uint64(), FAST(fa << shift).to_uint64(), a_raw, shift);
+    c.check(">>", S, AP(a >> shift).to_uint64(), FAST(fa >> shift).to_uint64(), a_raw, shift);
+    c.check("+int", S, AP(a + 3).to_uint64(), FAST(fa + 3).to_uint64(), a_raw, 3);
+    c.check("2*a-b", S, AP(2 * a - b).to_uint64(), FAST(2 * fa - fb).to_uint64(), a_raw, b_raw);
+
+    // comparisons at full precision, also against int constants
+    c.check("<", S, a < b, fa < fb, a_raw, b_raw);
+    c.check("<=", S, a <= b, fa <= fb, a_raw, b_raw);
+    c.check("==", S, a == b, fa == fb, a_raw, b_raw);
+    c.check("!=", S, a != b, fa != fb, a_raw, b_raw);
+    c.check("<0", S, a < 0, fa < 0, a_raw, 0);
+    c.check(">=1", S, a >= 1, fa >= 1, a_raw, 1);
+
+    // range / bit read and write
+    c.check("range", S, (uint64_t)a.range(hi, lo), (uint64_t)fa.range(hi, lo), a_raw, hi * 100 + lo);
+    AP ra = a;
+    FAST rfa = fa;
+    ra.range(hi, lo) = b;
+    rfa.range(hi, lo) = fb;
+    c.check("range=", S, ra.to_uint64(), rfa.to_uint64(), a_raw, b_raw);
+    c.check("bit", S, (bool)a[shift], (bool)fa[shift], a_raw, shift);
+    ra[shift] = !a[shift];
+    rfa[shift] = !fa[shift];
+    c.check("bit=", S, ra.to_uint64(), rfa.to_uint64(), a_raw, shift);
+
+    // compound and increment, wrapping at the type boundary
+    ra = a;
+    rfa = fa;
+    ra += b;
+    rfa += fb;
+    c.check("+=", S, ra.to_uint64(), rfa.to_uint64(), a_raw, b_raw);
+    ra -= 1;
+    rfa -= 1;
+    c.check("-=", S, ra.to_uint64(), rfa.to_uint64(), a_raw, b_raw);
+    ra++;
+    rfa++;
+    c.check("++", S, ra.to_uint64(), rfa.to_uint64(), a_raw, b_raw);
+    --ra;
+    --rfa;
+    c.check("--", S, ra.to_uint64(), rfa.to_uint64(), a_raw, b_raw);
+    ra >>= shift;
+    rfa >>= shift;
+    c.check(">>=", S, ra.to_uint64(), rfa.to_uint64(), a_raw, shift);
+}
+
+
+template <int W>
+uint64_t check_width(mt19937_64& gen, int trial_num) {
+    FastIntCheck c(gen, W);
+    for (int trial = 0; trial < trial_num; trial++) {
+        int64_t a_raw = c.random_value();
+        int64_t b_raw = c.random_value();
+        check_ops<W, false, ap_uint<W>>(c, a_raw, b_raw);
+        check_ops<W, true, ap_int<W>>(c, a_raw, b_raw);
+
+        // mixed signedness and width conversions
+        ap_uint<W> ua = a_raw;
+        ap_int<W> ib = b_raw;
+        hls_fast::fast_int<W, false> fua = a_raw;
+        hls_fast::fast_int<W, true> fib = b_raw;
+        c.check("int(uint)", true, ap_int<W>(ua).to_uint64(), hls_fast::fast_int<W, true>(fua).to_uint64(), a_raw, 0);
+        c.check("uint(int)", false, ap_uint<W>(ib).to_uint64(), hls_fast::fast_int<W, false>(fib).to_uint64(), b_raw, 0);
+        c.check("narrow", false, ap_uint<(W + 1) / 2>(ib).to_uint64(), hls_fast::fast_int<(W + 1) / 2, false>(fib).to_uint64(), b_raw, 0);
+        c.check("widen", true, ap_int<64>(ib).to_uint64(), hls_fast::fast_int<64, true>(fib).to_uint64(), b_raw, 0);
+        c.check("uint+int", true, ap_int<W>(ua + ib).to_uint64(), hls_fast::fast_int<W, true>(fua + fib).to_uint64(), a_raw, b_raw);
+        if (W < 64) {
+            c.check("uint<int", false, ua < ib, fua < fib, a_raw, b_raw);
+        }
+        c.check("from ap", false, hls_fast::fast_int<W, false>(ib).to_uint64(), ap_uint<W>(ib).to_uint64(), b_raw, 0);
+        c.check("to ap", true, ap_int<W>(fua).to_uint64(), ap_int<W>(ua).to_uint64(), a_raw, 0);
+    }
+    MAIN_INFO_1("w=" + to_string(W) + ": " + to_string(c.check_num - c.fail_num) + "/" + to_string(c.check_num) + " checks passed");
+    return c.fail_num;
+}
+
+
+// usage: hls_fast_int_check_main [trial_num] [seed]
+int main(const int argc, const char *argv[]) {
+    int trial_num = (argc > 1) ? atoi(argv[1]) : 20000;
+    unsigned seed = (argc > 2) ? (unsigned)strtoul(argv[2], nullptr, 0) : 1u;
+    MAIN_INFO_1("trial num: " + to_string(trial_num) + ", seed: " + to_string(seed));
+    mt19937_64 gen(seed);
+
+    // the widths the kernels instantiate plus the edges of the native mapping
+    uint64_t fail_num = 0;
+    fail_num += check_width<1>(gen, trial_num);
+    fail_num += check_width<2>(gen, trial_num);
+    fail_num += check_width<8>(gen, trial_num);
+    fail_num += check_width<9>(gen, trial_num);
+    fail_num += check_width<11>(gen, trial_num);
+    fail_num += check_width<12>(gen, trial_num);
+    fail_num += check_width<15>(gen, trial_num);
+    fail_num += check_width<16>(gen, trial_num);
+    fail_num += check_width<18>(gen, trial_num);
+    fail_num += check_width<19>(gen, trial_num);
+    fail_num += check_width<32>(gen, trial_num);
+    fail_num += check_width<33>(gen, trial_num);
+    fail_num += check_width<48>(gen, trial_num);
+    fail_num += check_width<63>(gen, trial_num);
+    fail_num += check_width<64>(gen, trial_num);
+
+    if (fail_num > 0) {
+        MAIN_INFO_1(to_string(fail_num) + " checks failed");
+        return 1;
+    }
+    MAIN_INFO_1("all checks passed");
+    return 0;
+}
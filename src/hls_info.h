@@ -4,6 +4,9 @@
 // std
 #include <string>
 #include <vector>
+#ifndef __SYNTHESIS__
+#include <functional>
+#endif
 
 // ip
 #include <ap_int.h>
@@ -14,6 +17,65 @@
 using std::string;
 
 
+// stream type used by the kernels and the C-sim harness
+// -DHLS_FAST_STREAM_SIM swaps in the ring buffer model for C-simulation, synthesis always sees hls::stream
+#if defined(HLS_FAST_STREAM_SIM) && !defined(__SYNTHESIS__)
+#include "hls_stream_sim.h"
+template <typename T>
+using hls_stream_t = hls_sim::stream<T>;
+
+template <typename T>
+inline void hls_stream_reserve(hls_sim::stream<T>& s, size_t n) { s.reserve(n); }
+template <typename T>
+inline void hls_stream_set_depth(hls_sim::stream<T>& s, size_t depth) { s.set_depth(depth); }
+#else
+template <typename T>
+using hls_stream_t = hls::stream<T>;
+
+template <typename T>
+inline void hls_stream_reserve(hls::stream<T>&, size_t) {}
+template <typename T>
+inline void hls_stream_set_depth(hls::stream<T>&, size_t) {}
+#endif
+
+// arbitrary precision types of the kernels, stream beats (ap_axiu) keep ap_uint
+// -DHLS_FAST_INT_SIM maps widths up to 63 bits to the native-backed hls_fast::fast_int (hls_fast_int.h)
+// for C-simulation, synthesis always sees ap_uint/ap_int
+// 64 bits stays ap_uint/ap_int: a native int64_t traps on INT64_MIN / -1 where ap_int<64> does not
+#if defined(HLS_FAST_INT_SIM) && !defined(__SYNTHESIS__)
+#include "hls_fast_int.h"
+template <int W, bool S, bool FAST = (W <= 63)>
+struct hls_int_select { typedef hls_fast::fast_int<W, S> type; };
+template <int W>
+struct hls_int_select<W, false, false> { typedef ap_uint<W> type; };
+template <int W>
+struct hls_int_select<W, true, false> { typedef ap_int<W> type; };
+
+template <int W>
+using hls_uint = typename hls_int_select<W, false>::type;
+template <int W>
+using hls_int = typename hls_int_select<W, true>::type;
+#else
+template <int W>
+using hls_uint = ap_uint<W>;
+template <int W>
+using hls_int = ap_int<W>;
+#endif
+
+// processes of a DATAFLOW region, HLS_DATAFLOW_PROCESS(name, call) wraps one process call
+// -DHLS_THREADED_DATAFLOW (with HLS_FAST_STREAM_SIM) runs the processes concurrently on blocking,
+// depth-bounded streams (hls_dataflow_sim.h), otherwise they run in call order as HLS C-sim does
+#if defined(HLS_THREADED_DATAFLOW) && defined(HLS_FAST_STREAM_SIM) && !defined(__SYNTHESIS__)
+#define HLS_DATAFLOW_BEGIN(name)            hls_sim::dataflow_region hls_dataflow_region_ref(name)
+#define HLS_DATAFLOW_PROCESS(name, ...)     hls_dataflow_region_ref.process(name, [&]() { __VA_ARGS__; })
+#define HLS_DATAFLOW_END()                  hls_dataflow_region_ref.run()
+#else
+#define HLS_DATAFLOW_BEGIN(name)
+#define HLS_DATAFLOW_PROCESS(name, ...)     __VA_ARGS__
+#define HLS_DATAFLOW_END()
+#endif
+
+
 struct HlsRegisterSection {
     ap_uint<16> reg_image_width;
     ap_uint<16> reg_image_height;
@@ -24,9 +86,21 @@ struct HlsRegisterSection {
     ap_uint<16> reg_crop_end_y;
     ap_uint<1>  reg_dpc_enable;
     ap_uint<16> reg_dpc_threshold;
-    vector<ap_uint<8>> reg_smooth_filter_coeff;
+#ifndef __SYNTHESIS__
+    vector<ap_uint<8>> reg_smooth_filter_coeff;     // not read by any kernel, kept out of the s_axilite map
+#endif
 };
 
+#ifndef __SYNTHESIS__
+// C-sim stand-in for the host writing s_axilite registers while a free-running kernel streams
+// (hls_pipeline_stream), called with the frame index right before the kernel latches the
+// registers of that frame
+inline std::function<void(unsigned)>& hls_register_write_hook() {
+    static std::function<void(unsigned)> hook;
+    return hook;
+}
+#endif
+
 struct HlsImageSection {
     // image info
     string image_path;
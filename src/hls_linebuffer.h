@@ -0,0 +1,94 @@
+#ifndef HLS_LINEBUFFER_H
+#define HLS_LINEBUFFER_H
+
+// std
+#include <ap_int.h>
+#ifndef __SYNTHESIS__
+#include <string>
+#include <cstdio>
+#include "print_function.h"
+#endif
+
+// ip
+#include "hls_info.h"
+
+// def
+#define HLS_LINEBUFFER_SECTION      "HlsLineBuffer"
+#define HLS_LINEBUFFER_MAX_WIDTH    8192
+#define HLS_BRAM18_BITS             18432
+#define HLS_URAM_BITS               294912   // 4096 x 72
+
+
+// HLS_ROWS rows of history for up to HLS_MAX_WIDTH pixels, HLS_PPC pixels of HLS_DATA_BITWIDTH per beat
+//  - the rows of one column are reshaped into a single HLS_ROWS*W*PPC bit word, so one read returns the
+//    whole column and one write shifts the new beat in (1R1W per beat, simple dual port)
+//  - history[k] is row (newest - k), a new row only ever shifts in at slot 0, so there is no row
+//    index arithmetic (the old [4] buffer indexed with %5)
+//  - packing the rows side by side fills BRAM/URAM words (8bit: 32 of 36 bits, 16bit: 64 of 72 bits)
+//    instead of one 2Kx9 / 1Kx18 BRAM per row
+template <int HLS_DATA_BITWIDTH, int HLS_PPC, int HLS_MAX_WIDTH, int HLS_ROWS>
+class HlsLineBuffer {
+public:
+    static_assert(HLS_MAX_WIDTH <= HLS_LINEBUFFER_MAX_WIDTH, "HlsLineBuffer supports up to 8192 pixels per row");
+
+    typedef hls_uint<HLS_DATA_BITWIDTH * HLS_PPC> beat_t;
+
+    static const int DEPTH = (HLS_MAX_WIDTH + HLS_PPC - 1) / HLS_PPC;      // beats per row
+    static const int WORD_BITS = HLS_ROWS * HLS_DATA_BITWIDTH * HLS_PPC;    // bits per column word
+
+    HlsLineBuffer() {};
+    ~HlsLineBuffer() {};
+
+    // history[k] = column b_cnt of row (newest - k)
+    void read(hls_uint<16> b_cnt, beat_t history[HLS_ROWS]) {
+        #pragma HLS INLINE
+        for (int k = 0; k < HLS_ROWS; k++) {
+            #pragma HLS UNROLL
+            history[k] = linebuffer[b_cnt][k];
+        }
+    }
+
+    // writes back history with new_beat as the newest row, the oldest row drops out
+    void shift_in(hls_uint<16> b_cnt, const beat_t history[HLS_ROWS], beat_t new_beat) {
+        #pragma HLS INLINE
+        linebuffer[b_cnt][0] = new_beat;
+        for (int k = 1; k < HLS_ROWS; k++) {
+            #pragma HLS UNROLL
+            linebuffer[b_cnt][k] = history[k - 1];
+        }
+    }
+
+#ifndef __SYNTHESIS__
+    // memory bits and the BRAM18 / URAM count for the reshaped word, best BRAM18 aspect ratio
+    static void report(const std::string& name) {
+        const int bram18_width[6] = {1, 2, 4, 9, 18, 36};
+        const int bram18_depth[6] = {16384, 8192, 4096, 2048, 1024, 512};
+        long long bram18_num = -1;
+        for (int i = 0; i < 6; i++) {
+            long long num = (long long)((WORD_BITS + bram18_width[i] - 1) / bram18_width[i]) * ((DEPTH + bram18_depth[i] - 1) / bram18_depth[i]);
+            if (bram18_num < 0 || num < bram18_num) {
+                bram18_num = num;
+            }
+        }
+        long long uram_num = (long long)((WORD_BITS + 71) / 72) * ((DEPTH + 4095) / 4096);
+        long long data_bits = (long long)WORD_BITS * DEPTH;
+
+        char line[256];
+        snprintf(line, sizeof(line), "%s: %d rows x %d pixels x %d bit, ppc %d -> %d x %d bit words, %lld bits",
+                 name.c_str(), HLS_ROWS, HLS_MAX_WIDTH, HLS_DATA_BITWIDTH, HLS_PPC, DEPTH, WORD_BITS, data_bits);
+        main_info(HLS_LINEBUFFER_SECTION, line);
+        snprintf(line, sizeof(line), "%s: BRAM18 x %lld (%.1f%% used), URAM x %lld (%.1f%% used)",
+                 name.c_str(), bram18_num, 100.0 * data_bits / (bram18_num * HLS_BRAM18_BITS),
+                 uram_num, 100.0 * data_bits / (uram_num * HLS_URAM_BITS));
+        main_info(HLS_LINEBUFFER_SECTION, line);
+    }
+#endif
+
+private:
+    beat_t linebuffer[DEPTH][HLS_ROWS];
+    #pragma HLS ARRAY_RESHAPE variable=linebuffer complete dim=2
+    #pragma HLS BIND_STORAGE variable=linebuffer type=ram_s2p impl=bram
+};
+
+
+#endif // HLS_LINEBUFFER_H
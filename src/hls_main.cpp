@@ -11,6 +11,7 @@
 #include "vector_function.h"
 #include "parse_json_function.h"
 #include "parse_csv_function.h"
+#include "frame_buffer_pool.h"
 
 // hls
 #include <ap_int.h>
@@ -25,15 +26,40 @@ using namespace std;
 
 // def
 // #define ALG_MAIN_SECTION "[AlgMain]"
-#define ALG_INPUT_DATA_TYPE uint16_t
-#define ALG_OUTPUT_DATA_TYPE uint16_t
-#define HLS_INPUT_DATA_BITWIDTH     8
-#define HLS_OUTPUT_DATA_BITWIDTH    8
 
 
+template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE, int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH>
+int run_hls_top(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section, bool dpc_stage_enable) {
+    // hls_top run, pixels packed as many per beat as fit in 32 bits
+    MAIN_INFO_1("hls_top run...");
+    HlsTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE, HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_AXIS_PACK_PPC(HLS_INPUT_DATA_BITWIDTH)> hls_top;
+    hls_top.hls_dpc_stage_enable = dpc_stage_enable;
+    hls_top.hls_stage_output_enable = dpc_stage_enable;
+    hls_top.run(register_section, image_section, output_section);
+    return 0;
+}
+
+
+// usage: hls_main [--dpc] [image_config.json] [register_table.csv]
+//  --dpc: dpc ahead of crop (default crop only, as alg_main) and write the dpc stage output
+//         (hls_dpc_output_path), to compare against alg_main --dpc
 int main(const int argc, const char *argv[]) {
     string register_table_csv_path = "../src/register_table.csv";
     string image_config_json_path = "../src/image_config.json";
+    bool dpc_stage_enable = false;
+    int path_num = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--dpc") {
+            dpc_stage_enable = true;
+        } else if (path_num == 0) {
+            image_config_json_path = arg;
+            path_num++;
+        } else if (path_num == 1) {
+            register_table_csv_path = arg;
+            path_num++;
+        }
+    }
 
     MAIN_INFO_1("image_config json parse");
     MAIN_INFO_1("image_config.image_section parse");
@@ -46,17 +72,26 @@ int main(const int argc, const char *argv[]) {
     RegisterSection register_section = LoadCSVFile(register_table_csv_path);
     register_section.print_values();
     
-    int width = register_section.reg_map["reg_image_width"];
-    int height = register_section.reg_map["reg_image_height"];
+    int width = register_section.value("reg_image_width");
+    int height = register_section.value("reg_image_height");
     MAIN_INFO_1("image width: " + to_string(width));
     MAIN_INFO_1("image height: " + to_string(height));
 
-    exit();
-    // hls_top run
-    MAIN_INFO_1("hls_top run...");
-    HlsTop<ALG_INPUT_DATA_TYPE, ALG_OUTPUT_DATA_TYPE, HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH> hls_top;
-    hls_top.run(register_section, image_section, output_section);
-    
-    return 0;
-// }
+    // kernel instantiation picked from the configured bit depth, 10/12 bit data keeps its range
+    int bitwidth = image_section.src_image_data_bitwidth;
+    MAIN_INFO_1("image data bitwidth: " + to_string(bitwidth));
+    int ret = -1;
+    if (bitwidth > 0 && bitwidth <= 8) {
+        ret = run_hls_top<uint8_t, uint8_t, 8, 8>(register_section, image_section, output_section, dpc_stage_enable);
+    } else if (bitwidth > 8 && bitwidth <= 10) {
+        ret = run_hls_top<uint16_t, uint16_t, 10, 10>(register_section, image_section, output_section, dpc_stage_enable);
+    } else if (bitwidth > 10 && bitwidth <= 12) {
+        ret = run_hls_top<uint16_t, uint16_t, 12, 12>(register_section, image_section, output_section, dpc_stage_enable);
+    } else if (bitwidth > 12 && bitwidth <= 16) {
+        ret = run_hls_top<uint16_t, uint16_t, 16, 16>(register_section, image_section, output_section, dpc_stage_enable);
+    } else {
+        MAIN_ERROR_1("Unsupported image data bitwidth: " + to_string(bitwidth));
+    }
+    FrameBufferPool::instance().print_stats();
+    return ret;
 }
\ No newline at end of file
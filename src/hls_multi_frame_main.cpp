@@ -0,0 +1,147 @@
+// std
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "alg_info.h"
+#include "alg_crop.h"
+#include "alg_dpc.h"
+#include "hls_info.h"
+#include "hls_axis_pack.h"
+#include "hls_pipeline.h"
+
+// def
+#define HLS_MULTI_FRAME_MAIN_SECTION "hls_multi_frame_main"
+#define HLS_MULTI_FRAME_MAX_WIDTH   300
+#define HLS_MULTI_FRAME_MAX_HEIGHT  40
+
+// using
+using namespace std;
+
+
+// frame_num frames of random size pushed back to back through one hls_pipeline_stream call,
+// the registers change at every frame boundary through hls_register_write_hook and some
+// frames are preceded by stray beats without SOF, every output frame is checked against AlgDpc + AlgCrop
+template <int HLS_PPC>
+int check_multi_frame(mt19937& gen, int frame_num) {
+    const int W = 8;
+    typedef HlsAxisPack<W, HLS_PPC> pack_t;
+    vector<HlsRegisterSection> frame_regs(frame_num);
+    vector<frame_vector<uint8_t>> alg_output_image(frame_num);
+    hls_stream_t<typename pack_t::beat_t> hls_input_stream;
+    hls_stream_t<typename pack_t::beat_t> hls_output_stream;
+
+    for (int f = 0; f < frame_num; f++) {
+        AlgRegisterSection alg_regs;
+        alg_regs.reg_image_width = uniform_int_distribution<int>(1, HLS_MULTI_FRAME_MAX_WIDTH)(gen);
+        alg_regs.reg_image_height = uniform_int_distribution<int>(1, HLS_MULTI_FRAME_MAX_HEIGHT)(gen);
+        alg_regs.reg_crop_enable = (f % 4) != 1;
+        alg_regs.reg_crop_start_x = uniform_int_distribution<int>(0, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_end_x = uniform_int_distribution<int>(alg_regs.reg_crop_start_x, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_start_y = uniform_int_distribution<int>(0, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_crop_end_y = uniform_int_distribution<int>(alg_regs.reg_crop_start_y, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_dpc_enable = (f % 4) != 2;
+        alg_regs.reg_dpc_threshold = uniform_int_distribution<int>(0, 64)(gen);
+
+        HlsRegisterSection& hls_regs = frame_regs[f];
+        hls_regs.reg_image_width = alg_regs.reg_image_width;
+        hls_regs.reg_image_height = alg_regs.reg_image_height;
+        hls_regs.reg_crop_enable = alg_regs.reg_crop_enable;
+        hls_regs.reg_crop_start_x = alg_regs.reg_crop_start_x;
+        hls_regs.reg_crop_start_y = alg_regs.reg_crop_start_y;
+        hls_regs.reg_crop_end_x = alg_regs.reg_crop_end_x;
+        hls_regs.reg_crop_end_y = alg_regs.reg_crop_end_y;
+        hls_regs.reg_dpc_enable = alg_regs.reg_dpc_enable;
+        hls_regs.reg_dpc_threshold = alg_regs.reg_dpc_threshold;
+
+        frame_vector<uint8_t> input_image(alg_regs.reg_image_width * alg_regs.reg_image_height);
+        uniform_int_distribution<int> pixel_distrib(0, 255);
+        for (size_t i = 0; i < input_image.size(); i++) {
+            input_image[i] = pixel_distrib(gen);
+        }
+
+        // alg reference, dpc -> crop
+        frame_vector<uint8_t> alg_dpc_image;
+        AlgDpc<uint8_t, uint8_t>::process_image(input_image, alg_dpc_image, alg_regs.reg_image_width, alg_regs.reg_image_height,
+                                                alg_regs.reg_dpc_enable, alg_regs.reg_dpc_threshold);
+        AlgCrop<uint8_t, uint8_t> alg_crop;
+        alg_crop.run(alg_dpc_image, alg_output_image[f], alg_regs);
+
+        // stray beats of a source that started mid-frame, no SOF among them
+        if (f % 3 == 2) {
+            int stray_num = uniform_int_distribution<int>(1, 5)(gen);
+            for (int i = 0; i < stray_num; i++) {
+                typename pack_t::beat_t beat;
+                beat.data = gen();
+                beat.keep = -1;
+                beat.strb = -1;
+                beat.user = 0;
+                beat.last = (i == stray_num - 1) ? 1 : 0;
+                hls_input_stream.write(beat);
+            }
+        }
+        pack_t::pack_frame(input_image, alg_regs.reg_image_width, alg_regs.reg_image_height, hls_input_stream);
+    }
+
+    // host side: the registers of frame f are written before the kernel latches them
+    HlsRegisterSection live_regs = frame_regs[0];
+    hls_register_write_hook() = [&](unsigned frame) {
+        if (frame < frame_regs.size()) {
+            live_regs = frame_regs[frame];
+        }
+    };
+    hls_pipeline_stream<W, W, HLS_PPC>(hls_input_stream, hls_output_stream, live_regs);
+    hls_register_write_hook() = nullptr;
+
+    int fail_num = 0;
+    for (int f = 0; f < frame_num; f++) {
+        const HlsRegisterSection& hls_regs = frame_regs[f];
+        int output_width = hls_regs.reg_crop_enable ? (int)(hls_regs.reg_crop_end_x - hls_regs.reg_crop_start_x + 1) : (int)hls_regs.reg_image_width;
+        int output_height = hls_regs.reg_crop_enable ? (int)(hls_regs.reg_crop_end_y - hls_regs.reg_crop_start_y + 1) : (int)hls_regs.reg_image_height;
+        frame_vector<uint8_t> hls_output_image;
+        bool framing_ok = pack_t::unpack_frame(hls_output_stream, output_width, output_height, hls_output_image);
+        bool data_ok = (hls_output_image == alg_output_image[f]);
+        if (!framing_ok || !data_ok) {
+            fail_num++;
+            MAIN_INFO_1("multi frame ppc=" + to_string(HLS_PPC) + " frame " + to_string(f) + " FAIL: "
+                        + to_string((int)hls_regs.reg_image_width) + "x" + to_string((int)hls_regs.reg_image_height)
+                        + " crop=" + to_string((int)hls_regs.reg_crop_enable) + " dpc=" + to_string((int)hls_regs.reg_dpc_enable)
+                        + (framing_ok ? "" : " framing") + (data_ok ? "" : " data"));
+        }
+    }
+    if (!hls_input_stream.empty() || !hls_output_stream.empty()) {
+        fail_num++;
+        MAIN_INFO_1("multi frame ppc=" + to_string(HLS_PPC) + " FAIL: beats left over after the last frame");
+    }
+    MAIN_INFO_1("multi frame ppc=" + to_string(HLS_PPC) + ": " + to_string(frame_num - fail_num) + "/" + to_string(frame_num) + " frames passed");
+    return fail_num;
+}
+
+
+// usage: hls_multi_frame_main [frame_num] [seed]
+int main(const int argc, const char *argv[]) {
+    int frame_num = (argc > 1) ? atoi(argv[1]) : 32;
+    unsigned seed = (argc > 2) ? (unsigned)strtoul(argv[2], nullptr, 0) : 1u;
+    MAIN_INFO_1("frame num: " + to_string(frame_num) + ", seed: " + to_string(seed));
+    mt19937 gen(seed);
+
+    int fail_num = 0;
+    fail_num += check_multi_frame<1>(gen, frame_num);
+    fail_num += check_multi_frame<2>(gen, frame_num);
+    fail_num += check_multi_frame<4>(gen, frame_num);
+    FrameBufferPool::instance().print_stats();
+
+    if (fail_num > 0) {
+        MAIN_ERROR_1(to_string(fail_num) + " checks failed");
+    }
+    MAIN_INFO_1("all checks passed");
+    return 0;
+}
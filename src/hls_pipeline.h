@@ -0,0 +1,148 @@
+#ifndef HLS_PIPELINE_H
+#define HLS_PIPELINE_H
+
+// std
+#include <ap_int.h>
+#include <hls_stream.h>
+#include "ap_axi_sdata.h"
+
+// ip
+#include "hls_info.h"
+#include "hls_csim_profile.h"
+#include "hls_axis_pack.h"
+#include "hls_dpc.h"
+#include "hls_crop_ppc.h"
+
+// def
+#define HLS_PIPELINE_SECTION            "hls_pipeline"
+#define HLS_PIPELINE_DPC_CROP_DEPTH     2       // dpc -> crop FIFO, see the HLS_CSIM_PROFILE fifo report
+#define HLS_PIPELINE_ALIGN_DEPTH        2       // align -> dpc FIFO
+
+
+// kernel instances of one pipeline, they keep their line buffers across the frames of their owner
+// C-sim harnesses own one per HlsTop, so concurrent workers (cross_check_fuzz) each drive their own
+// and it goes away with the worker, the synthesis tops use the static one of hls_pipeline() below
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC, int HLS_MAX_WIDTH = HLS_DPC_MAX_WIDTH>
+struct HlsPipelineKernel {
+    HlsDpc<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH> hls_dpc;
+    HlsCropPpc<HLS_OUTPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC> hls_crop;
+};
+
+
+// passes the frame_beats beats of one frame, dropping whatever arrives ahead of its SOF (user),
+// so a source that starts mid-frame or a truncated frame does not shift every later frame
+template <typename BEAT>
+void hls_frame_align(hls_stream_t<BEAT>& input_stream, hls_stream_t<BEAT>& output_stream, hls_uint<32> frame_beats) {
+    bool in_frame = false;
+    hls_uint<32> beat_cnt = 0;
+#ifndef __SYNTHESIS__
+    size_t drop_num = 0;
+#endif
+    while (beat_cnt < frame_beats) {
+        #pragma HLS PIPELINE II=1
+        BEAT beat = input_stream.read();
+        in_frame = in_frame || beat.user;
+        if (in_frame) {
+            output_stream.write(beat);
+            beat_cnt++;
+        }
+#ifndef __SYNTHESIS__
+        else {
+            drop_num++;
+        }
+#endif
+    }
+#ifndef __SYNTHESIS__
+    if (drop_num > 0) {
+        main_info(HLS_PIPELINE_SECTION, "dropped " + std::to_string(drop_num) + " beats ahead of SOF");
+    }
+#endif
+}
+
+
+// align -> DPC -> crop under DATAFLOW, the kernels overlap and only exchange beats through FIFOs
+//  - one call is one frame: user(SOF) on its first beat, last(EOL) on the final beat of every row
+//  - each stage bypasses itself when its reg_*_enable is 0
+//  - HlsAxisPack beats carry HLS_PPC pixels, the FIFO depth is in beats
+//  - HLS_MAX_WIDTH sizes the DPC line buffer
+// in a sequential C-sim the whole DPC frame sits in the FIFO before crop reads it, so the FIFO is
+// left unbounded there, the depth that hardware needs comes from the HLS_CSIM_PROFILE fifo report
+// with HLS_THREADED_DATAFLOW both kernels run concurrently and the FIFO keeps its hardware depth
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC, int HLS_MAX_WIDTH>
+void hls_pipeline(
+    hls_stream_t<typename HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& input_stream,
+    hls_stream_t<typename HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& output_stream,
+    const HlsRegisterSection& hls_register_section,
+    HlsPipelineKernel<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH>& hls_pipeline_kernel
+) {
+    #pragma HLS DATAFLOW
+
+    hls_uint<32> frame_beats = hls_uint<32>((hls_register_section.reg_image_width + HLS_PPC - 1) / HLS_PPC) * hls_register_section.reg_image_height;
+    hls_stream_t<typename HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC>::beat_t> align_to_dpc_stream("align_to_dpc_stream");
+    #pragma HLS STREAM variable=align_to_dpc_stream depth=HLS_PIPELINE_ALIGN_DEPTH
+    hls_stream_t<typename HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC>::beat_t> dpc_to_crop_stream("dpc_to_crop_stream");
+    #pragma HLS STREAM variable=dpc_to_crop_stream depth=HLS_PIPELINE_DPC_CROP_DEPTH
+#if defined(HLS_THREADED_DATAFLOW) && !defined(__SYNTHESIS__)
+    hls_stream_set_depth(align_to_dpc_stream, HLS_PIPELINE_ALIGN_DEPTH);
+    hls_stream_set_depth(dpc_to_crop_stream, HLS_PIPELINE_DPC_CROP_DEPTH);
+#elif !defined(__SYNTHESIS__)
+    hls_stream_reserve(align_to_dpc_stream, (size_t)frame_beats);
+    hls_stream_reserve(dpc_to_crop_stream, (size_t)frame_beats);
+#endif
+    HLS_PROFILE_FIFO_TRACE(dpc_to_crop_stream);
+
+    HLS_DATAFLOW_BEGIN("hls_pipeline");
+    HLS_DATAFLOW_PROCESS("align", hls_frame_align(input_stream, align_to_dpc_stream, frame_beats));
+    HLS_DATAFLOW_PROCESS("dpc", hls_pipeline_kernel.hls_dpc.run(align_to_dpc_stream, dpc_to_crop_stream, hls_register_section));
+    HLS_DATAFLOW_PROCESS("crop", hls_pipeline_kernel.hls_crop.run(dpc_to_crop_stream, output_stream, hls_register_section));
+    HLS_DATAFLOW_END();
+
+    HLS_PROFILE_FIFO_REPORT(dpc_to_crop_stream, "dpc_to_crop_stream");
+}
+
+
+// one static kernel instance, for the synthesis tops (hls_top.cpp) and single threaded testbenches
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC, int HLS_MAX_WIDTH = HLS_DPC_MAX_WIDTH>
+void hls_pipeline(
+    hls_stream_t<typename HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& input_stream,
+    hls_stream_t<typename HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& output_stream,
+    const HlsRegisterSection& hls_register_section
+) {
+    #pragma HLS INLINE
+    static HlsPipelineKernel<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH> hls_pipeline_kernel;
+    hls_pipeline<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH>(input_stream, output_stream, hls_register_section, hls_pipeline_kernel);
+}
+
+
+// free-running multi-frame version of hls_pipeline for an ap_ctrl_none top, started once
+//  - frames follow each other on the same streams, each one framed by SOF / EOL
+//  - the registers are latched once per frame before its first beat is accepted, so host writes
+//    to s_axilite (size, crop window, enables, threshold) take effect at the next frame boundary
+//    and never change a frame in flight
+// C-sim leaves the loop once the input is empty at a frame boundary, hls_register_write_hook()
+// plays the host register writes between frames
+template <int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC, int HLS_MAX_WIDTH = HLS_DPC_MAX_WIDTH>
+void hls_pipeline_stream(
+    hls_stream_t<typename HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& input_stream,
+    hls_stream_t<typename HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC>::beat_t>& output_stream,
+    const HlsRegisterSection& hls_register_section
+) {
+    hls_uint<32> frame_cnt = 0;
+    for (;;) {
+#ifndef __SYNTHESIS__
+        if (input_stream.empty()) {
+            break;
+        }
+        if (hls_register_write_hook()) {
+            hls_register_write_hook()(frame_cnt);
+        }
+#endif
+        // 帧边界锁存寄存器
+        HlsRegisterSection frame_register_section = hls_register_section;
+        hls_pipeline<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC, HLS_MAX_WIDTH>(input_stream, output_stream, frame_register_section);
+        frame_cnt++;
+    }
+}
+
+
+#endif // HLS_PIPELINE_H
@@ -0,0 +1,206 @@
+// std
+#include <iostream>
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+
+// ip
+#include "alg_info.h"
+#include "alg_crop.h"
+#include "alg_dpc.h"
+#include "hls_info.h"
+#include "hls_axis_pack.h"
+#include "hls_crop_ppc.h"
+#include "hls_dpc.h"
+
+// def
+#define HLS_PPC_CHECK_MAIN_SECTION "hls_ppc_check_main"
+#define HLS_PPC_CHECK_MAX_WIDTH     300
+#define HLS_PPC_CHECK_MAX_HEIGHT    40
+
+// using
+using namespace std;
+
+
+// random frame sizes and crop windows (edges anywhere inside a beat), HlsCropPpc vs AlgCrop
+template <int W, int HLS_PPC, typename T>
+int check_crop_ppc(mt19937& gen, int trial_num) {
+    typedef HlsAxisPack<W, HLS_PPC> pack_t;
+    int fail_num = 0;
+    for (int trial = 0; trial < trial_num; trial++) {
+        AlgRegisterSection alg_regs;
+        alg_regs.reg_image_width = uniform_int_distribution<int>(1, HLS_PPC_CHECK_MAX_WIDTH)(gen);
+        alg_regs.reg_image_height = uniform_int_distribution<int>(1, HLS_PPC_CHECK_MAX_HEIGHT)(gen);
+        alg_regs.reg_crop_enable = (trial % 8) != 0;
+        alg_regs.reg_crop_start_x = uniform_int_distribution<int>(0, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_end_x = uniform_int_distribution<int>(alg_regs.reg_crop_start_x, alg_regs.reg_image_width - 1)(gen);
+        alg_regs.reg_crop_start_y = uniform_int_distribution<int>(0, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_crop_end_y = uniform_int_distribution<int>(alg_regs.reg_crop_start_y, alg_regs.reg_image_height - 1)(gen);
+        alg_regs.reg_dpc_enable = false;
+        alg_regs.reg_dpc_threshold = 0;
+
+        HlsRegisterSection hls_regs;
+        hls_regs.reg_image_width = alg_regs.reg_image_width;
+        hls_regs.reg_image_height = alg_regs.reg_image_height;
+        hls_regs.reg_crop_enable = alg_regs.reg_crop_enable;
+        hls_regs.reg_crop_start_x = alg_regs.reg_crop_start_x;
+        hls_regs.reg_crop_start_y = alg_regs.reg_crop_start_y;
+        hls_regs.reg_crop_end_x = alg_regs.reg_crop_end_x;
+        hls_regs.reg_crop_end_y = alg_regs.reg_crop_end_y;
+        hls_regs.reg_dpc_enable = 0;
+        hls_regs.reg_dpc_threshold = 0;
+
+        frame_vector<T> input_image(alg_regs.reg_image_width * alg_regs.reg_image_height);
+        uniform_int_distribution<int> pixel_distrib(0, (1 << W) - 1);
+        for (size_t i = 0; i < input_image.size(); i++) {
+            input_image[i] = pixel_distrib(gen);
+        }
+
+        // alg reference
+        frame_vector<T> alg_output_image;
+        AlgCrop<T, T> alg_crop;
+        alg_crop.run(input_image, alg_output_image, alg_regs);
+
+        // hls
+        hls_stream_t<typename pack_t::beat_t> hls_input_stream;
+        hls_stream_t<typename pack_t::beat_t> hls_output_stream;
+        pack_t::pack_frame(input_image, alg_regs.reg_image_width, alg_regs.reg_image_height, hls_input_stream);
+        HlsCropPpc<W, W, HLS_PPC> hls_crop_ppc;
+        hls_crop_ppc.run(hls_input_stream, hls_output_stream, hls_regs);
+
+        int output_width = alg_regs.reg_crop_enable ? alg_regs.reg_crop_end_x - alg_regs.reg_crop_start_x + 1 : alg_regs.reg_image_width;
+        int output_height = alg_regs.reg_crop_enable ? alg_regs.reg_crop_end_y - alg_regs.reg_crop_start_y + 1 : alg_regs.reg_image_height;
+        frame_vector<T> hls_output_image;
+        bool framing_ok = pack_t::unpack_frame(hls_output_stream, output_width, output_height, hls_output_image) && hls_output_stream.empty();
+        bool data_ok = (hls_output_image == alg_output_image);
+
+        if (!framing_ok || !data_ok || !hls_input_stream.empty()) {
+            fail_num++;
+            MAIN_INFO_1("crop w=" + to_string(W) + " ppc=" + to_string(HLS_PPC) + " trial " + to_string(trial) + " FAIL: "
+                        + to_string(alg_regs.reg_image_width) + "x" + to_string(alg_regs.reg_image_height)
+                        + " enable=" + to_string(alg_regs.reg_crop_enable)
+                        + " x=[" + to_string(alg_regs.reg_crop_start_x) + "," + to_string(alg_regs.reg_crop_end_x) + "]"
+                        + " y=[" + to_string(alg_regs.reg_crop_start_y) + "," + to_string(alg_regs.reg_crop_end_y) + "]"
+                        + (framing_ok ? "" : " framing") + (data_ok ? "" : " data"));
+        }
+    }
+    MAIN_INFO_1("crop w=" + to_string(W) + " ppc=" + to_string(HLS_PPC) + ": " + to_string(trial_num - fail_num) + "/" + to_string(trial_num) + " passed");
+    return fail_num;
+}
+
+
+// random frame sizes, thresholds and injected hot/dead pixels, HlsDpc vs AlgDpc::process_image
+// small frames (down to 1x1) exercise the clamped borders on every side, every 16th frame is
+// a few rows at (close to) HLS_MAX_WIDTH to fill the whole line buffer
+template <int W, int HLS_PPC, typename T, int HLS_MAX_WIDTH = HLS_DPC_MAX_WIDTH>
+int check_dpc_ppc(mt19937& gen, int trial_num) {
+    typedef HlsAxisPack<W, HLS_PPC> pack_t;
+    const int max_value = (1 << W) - 1;
+    int fail_num = 0;
+    HlsDpc<W, W, HLS_PPC, HLS_MAX_WIDTH>::report_memory();
+    for (int trial = 0; trial < trial_num; trial++) {
+        int width = uniform_int_distribution<int>(1, HLS_PPC_CHECK_MAX_WIDTH)(gen);
+        int height = uniform_int_distribution<int>(1, HLS_PPC_CHECK_MAX_HEIGHT)(gen);
+        if (trial % 16 == 15) {
+            width = HLS_MAX_WIDTH - uniform_int_distribution<int>(0, 2 * HLS_PPC)(gen);
+            height = uniform_int_distribution<int>(1, 6)(gen);
+        }
+        bool enable = (trial % 8) != 0;
+        int threshold = uniform_int_distribution<int>(0, max_value / 4)(gen);
+
+        // smooth background plus noise, ~2% of the pixels forced to 0 or max
+        frame_vector<T> input_image(width * height);
+        uniform_int_distribution<int> noise_distrib(-max_value / 16, max_value / 16);
+        uniform_int_distribution<int> defect_distrib(0, 99);
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) {
+                int value = (x * 7 + y * 3) % (max_value / 2 + 1) + max_value / 4 + noise_distrib(gen);
+                int defect = defect_distrib(gen);
+                if (defect == 0) {
+                    value = 0;
+                } else if (defect == 1) {
+                    value = max_value;
+                }
+                input_image[y * width + x] = static_cast<T>(max(0, min(max_value, value)));
+            }
+        }
+
+        // alg reference
+        frame_vector<T> alg_output_image;
+        AlgDpc<T, T>::process_image(input_image, alg_output_image, width, height, enable, threshold);
+
+        // hls
+        HlsRegisterSection hls_regs;
+        hls_regs.reg_image_width = width;
+        hls_regs.reg_image_height = height;
+        hls_regs.reg_crop_enable = 0;
+        hls_regs.reg_crop_start_x = 0;
+        hls_regs.reg_crop_start_y = 0;
+        hls_regs.reg_crop_end_x = width - 1;
+        hls_regs.reg_crop_end_y = height - 1;
+        hls_regs.reg_dpc_enable = enable;
+        hls_regs.reg_dpc_threshold = threshold;
+
+        hls_stream_t<typename pack_t::beat_t> hls_input_stream;
+        hls_stream_t<typename pack_t::beat_t> hls_output_stream;
+        pack_t::pack_frame(input_image, width, height, hls_input_stream);
+        HlsDpc<W, W, HLS_PPC, HLS_MAX_WIDTH> hls_dpc;
+        hls_dpc.run(hls_input_stream, hls_output_stream, hls_regs);
+
+        frame_vector<T> hls_output_image;
+        bool framing_ok = pack_t::unpack_frame(hls_output_stream, width, height, hls_output_image) && hls_output_stream.empty();
+        bool data_ok = (hls_output_image == alg_output_image);
+
+        if (!framing_ok || !data_ok || !hls_input_stream.empty()) {
+            fail_num++;
+            size_t mismatch = 0;
+            for (size_t i = 0; i < hls_output_image.size() && i < alg_output_image.size(); i++) {
+                mismatch += (hls_output_image[i] != alg_output_image[i]);
+            }
+            MAIN_INFO_1("dpc w=" + to_string(W) + " ppc=" + to_string(HLS_PPC) + " trial " + to_string(trial) + " FAIL: "
+                        + to_string(width) + "x" + to_string(height) + " enable=" + to_string(enable)
+                        + " threshold=" + to_string(threshold) + " mismatch=" + to_string(mismatch)
+                        + (framing_ok ? "" : " framing"));
+        }
+    }
+    MAIN_INFO_1("dpc w=" + to_string(W) + " ppc=" + to_string(HLS_PPC) + ": " + to_string(trial_num - fail_num) + "/" + to_string(trial_num) + " passed");
+    return fail_num;
+}
+
+
+// usage: hls_ppc_check_main [trial_num] [seed]
+int main(const int argc, const char *argv[]) {
+    int trial_num = (argc > 1) ? atoi(argv[1]) : 200;
+    unsigned seed = (argc > 2) ? (unsigned)strtoul(argv[2], nullptr, 0) : 1u;
+    MAIN_INFO_1("trial num: " + to_string(trial_num) + ", seed: " + to_string(seed));
+    mt19937 gen(seed);
+
+    int fail_num = 0;
+    fail_num += check_crop_ppc<8, 1, uint8_t>(gen, trial_num);
+    fail_num += check_crop_ppc<8, 2, uint8_t>(gen, trial_num);
+    fail_num += check_crop_ppc<8, 4, uint8_t>(gen, trial_num);
+    fail_num += check_crop_ppc<8, 8, uint8_t>(gen, trial_num);
+    fail_num += check_crop_ppc<10, 3, uint16_t>(gen, trial_num);
+    fail_num += check_crop_ppc<12, 2, uint16_t>(gen, trial_num);
+    fail_num += check_crop_ppc<16, 4, uint16_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<8, 1, uint8_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<8, 2, uint8_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<8, 4, uint8_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<10, 3, uint16_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<12, 2, uint16_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<16, 4, uint16_t>(gen, trial_num);
+    fail_num += check_dpc_ppc<8, 1, uint8_t, 8192>(gen, trial_num);
+    fail_num += check_dpc_ppc<12, 2, uint16_t, 8192>(gen, trial_num);
+
+    if (fail_num > 0) {
+        MAIN_ERROR_1(to_string(fail_num) + " checks failed");
+    }
+    MAIN_INFO_1("all checks passed");
+    return 0;
+}
@@ -0,0 +1,236 @@
+#ifndef HLS_STREAM_SIM_H
+#define HLS_STREAM_SIM_H
+
+// C-simulation only replacement for hls::stream, selected with -DHLS_FAST_STREAM_SIM
+// hls::stream is a std::deque under the hood, this is a preallocated ring buffer
+// with the same read/write/empty API plus bulk read_n/write_n
+// storage comes from the FrameBufferPool, so per-frame streams reuse already faulted-in memory
+// with -DHLS_THREADED_DATAFLOW every access takes the stream mutex, and a dataflow process blocks
+// on an empty / full (set_depth) stream instead of reporting an error, see hls_dataflow_sim.h
+
+#ifdef __SYNTHESIS__
+#error "hls_stream_sim.h is a C-simulation model and must not be synthesized"
+#endif
+
+// std
+#include <vector>
+#include <string>
+#include <cstddef>
+#include <algorithm>
+
+// tool
+#include "print_function.h"
+#include "frame_buffer_pool.h"
+#ifdef HLS_THREADED_DATAFLOW
+#include <mutex>
+#include <condition_variable>
+#include "hls_dataflow_sim.h"
+#endif
+
+// using
+using std::string;
+
+
+namespace hls_sim {
+
+template <typename T>
+class stream {
+public:
+    stream() : stream_name("hls_sim::stream") { init(); }
+    explicit stream(const char* name) : stream_name(name) { init(); }
+
+    // depth = 0: unbounded (grows by doubling), otherwise behaves like #pragma HLS STREAM depth=N
+    void set_depth(size_t depth) {
+        stream_lock lock = lock_stream();
+        stream_depth = depth;
+        if (depth > stream_buffer.size()) {
+            resize_buffer(depth);
+        }
+    }
+
+    size_t get_depth() const { return stream_depth; }
+
+    void reserve(size_t n) {
+        stream_lock lock = lock_stream();
+        if (n > stream_buffer.size()) {
+            resize_buffer(n);
+        }
+    }
+
+    bool empty() const { stream_lock lock = lock_stream(); return stream_count == 0; }
+    bool full() const { stream_lock lock = lock_stream(); return is_full(); }
+    size_t size() const { stream_lock lock = lock_stream(); return stream_count; }
+    const string& name() const { return stream_name; }
+
+    void write(const T& data) {
+        stream_lock lock = lock_stream();
+        make_room(lock, 1);
+        stream_buffer[wrap(stream_head + stream_count)] = data;
+        stream_count++;
+        notify_readable();
+    }
+
+    T read() {
+        stream_lock lock = lock_stream();
+        wait_readable(lock, 1);
+        if (stream_count == 0) {
+            report_error("read while empty");
+        }
+        T data = stream_buffer[stream_head];
+        stream_head = wrap(stream_head + 1);
+        stream_count--;
+        notify_writable();
+        return data;
+    }
+
+    void read(T& data) { data = read(); }
+
+    bool read_nb(T& data) {
+        if (empty()) {
+            return false;
+        }
+        data = read();
+        return true;
+    }
+
+    bool write_nb(const T& data) {
+        if (full()) {
+            return false;
+        }
+        write(data);
+        return true;
+    }
+
+    stream& operator>>(T& data) { read(data); return *this; }
+    stream& operator<<(const T& data) { write(data); return *this; }
+
+    // bulk copy in at most two contiguous segments
+    void write_n(const T* data, size_t n) {
+        stream_lock lock = lock_stream();
+        make_room(lock, n);
+        size_t tail = wrap(stream_head + stream_count);
+        size_t first = std::min(n, stream_buffer.size() - tail);
+        std::copy(data, data + first, stream_buffer.begin() + tail);
+        std::copy(data + first, data + n, stream_buffer.begin());
+        stream_count += n;
+        notify_readable();
+    }
+
+    void read_n(T* data, size_t n) {
+        stream_lock lock = lock_stream();
+        wait_readable(lock, n);
+        if (n > stream_count) {
+            report_error("read_n past the end");
+        }
+        size_t first = std::min(n, stream_buffer.size() - stream_head);
+        std::copy(stream_buffer.begin() + stream_head, stream_buffer.begin() + stream_head + first, data);
+        std::copy(stream_buffer.begin(), stream_buffer.begin() + (n - first), data + first);
+        stream_head = wrap(stream_head + n);
+        stream_count -= n;
+        notify_writable();
+    }
+
+private:
+    void init() {
+        stream_depth = 0;
+        stream_head = 0;
+        stream_count = 0;
+#ifdef HLS_THREADED_DATAFLOW
+        read_waiting = 0;
+        write_waiting = 0;
+#endif
+        resize_buffer(16);
+    }
+
+#ifdef HLS_THREADED_DATAFLOW
+    typedef std::unique_lock<std::mutex> stream_lock;
+    stream_lock lock_stream() const { return stream_lock(stream_mutex); }
+
+    // only dataflow processes block, the testbench thread keeps the sequential errors
+    void wait_readable(stream_lock& lock, size_t n) {
+        if (stream_depth > 0 && n > stream_depth) {
+            // a bounded FIFO never holds more than depth items, the read would block forever
+            report_error("read_n of " + std::to_string(n) + " on stream of depth " + std::to_string(stream_depth) + ", would deadlock");
+        }
+        if (stream_count < n && dataflow_scheduler::in_process()) {
+            dataflow_scheduler::instance().block(stream_name, "read");
+            read_waiting++;
+            readable_cv.wait(lock, [&]() { return stream_count >= n; });
+            read_waiting--;
+            dataflow_scheduler::instance().unblock();
+        }
+    }
+
+    void wait_writable(stream_lock& lock, size_t n) {
+        if (stream_depth > 0 && stream_count + n > stream_depth && n <= stream_depth && dataflow_scheduler::in_process()) {
+            dataflow_scheduler::instance().block(stream_name, "write");
+            write_waiting++;
+            writable_cv.wait(lock, [&]() { return stream_count + n <= stream_depth; });
+            write_waiting--;
+            dataflow_scheduler::instance().unblock();
+        }
+    }
+
+    void notify_readable() { if (read_waiting > 0) readable_cv.notify_all(); }
+    void notify_writable() { if (write_waiting > 0) writable_cv.notify_all(); }
+#else
+    struct stream_lock { ~stream_lock() {} };
+    stream_lock lock_stream() const { return stream_lock(); }
+    void wait_readable(stream_lock&, size_t) {}
+    void wait_writable(stream_lock&, size_t) {}
+    void notify_readable() {}
+    void notify_writable() {}
+#endif
+
+    bool is_full() const { return stream_depth > 0 && stream_count >= stream_depth; }
+
+    void make_room(stream_lock& lock, size_t n) {
+        wait_writable(lock, n);
+        if (stream_depth > 0 && stream_count + n > stream_depth) {
+            // a blocking write on a full FIFO never returns in a sequential C-sim
+            report_error("write on full stream (depth " + std::to_string(stream_depth) + "), would deadlock");
+        }
+        if (stream_count + n > stream_buffer.size()) {
+            resize_buffer(std::max(stream_count + n, 2 * stream_buffer.size()));
+        }
+    }
+
+    // index < 2 * capacity, a compare is cheaper than rounding capacity up to a power of two
+    // (a frame sized reserve would otherwise allocate up to twice the frame)
+    size_t wrap(size_t index) const {
+        return index >= stream_buffer.size() ? index - stream_buffer.size() : index;
+    }
+
+    // exact capacity, reserve(frame size) allocates the frame once
+    void resize_buffer(size_t capacity) {
+        frame_vector<T> buffer(capacity);
+        for (size_t i = 0; i < stream_count; i++) {
+            buffer[i] = stream_buffer[wrap(stream_head + i)];
+        }
+        stream_buffer.swap(buffer);
+        stream_head = 0;
+    }
+
+    // kept out of line so read/write inline to a compare and a copy
+    __attribute__((noinline, cold)) void report_error(const string& message) const {
+        MAIN_ERROR_1("hls_sim::stream '" + stream_name + "' " + message);
+    }
+
+    string stream_name;
+    frame_vector<T> stream_buffer;
+    size_t stream_depth;
+    size_t stream_head;
+    size_t stream_count;
+#ifdef HLS_THREADED_DATAFLOW
+    mutable std::mutex stream_mutex;
+    std::condition_variable readable_cv;
+    std::condition_variable writable_cv;
+    int read_waiting;
+    int write_waiting;
+#endif
+};
+
+} // namespace hls_sim
+
+
+#endif // HLS_STREAM_SIM_H
@@ -1,20 +1,47 @@
-// // std
-// #include <iostream>
-// #include <fstream>
-// #include <sstream>
-// #include <vector>
-// #include <random>
-// #include <string>
-
-// // tool
-// #include "json.hpp"
-// #include "vector_function.hpp"
-
-// // ip
-// #include "hls_crop.h"
-// #include "hls_dpc.h"
-
-// // using
-// using json = nlohmann::json;
-// using namespace std;
-// using namespace hls;
+// synthesis top function, set as the top in the Vitis HLS project (set_top hls_top)
+// the C-sim harness (HlsTop in hls_top.h) runs the same hls_pipeline on vectors
+
+// ip
+#include "hls_info.h"
+#include "hls_pipeline.h"
+
+// def
+#ifndef HLS_TOP_DATA_BITWIDTH
+#define HLS_TOP_DATA_BITWIDTH   8       // 10/12 bit sensors keep their range, e.g. 10 with HLS_TOP_PPC 3
+#endif
+#ifndef HLS_TOP_PPC
+#define HLS_TOP_PPC             1       // pixels per beat, HLS_AXIS_PACK_PPC(W) fills a 32 bit TDATA
+#endif
+#ifndef HLS_TOP_MAX_WIDTH
+#define HLS_TOP_MAX_WIDTH       HLS_DPC_MAX_WIDTH   // DPC line buffer size, up to 8192
+#endif
+
+
+void hls_top(
+    hls_stream_t<HlsAxisPack<HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC>::beat_t>& input_stream,
+    hls_stream_t<HlsAxisPack<HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC>::beat_t>& output_stream,
+    const HlsRegisterSection& hls_register_section
+) {
+    #pragma HLS INTERFACE axis port=input_stream
+    #pragma HLS INTERFACE axis port=output_stream
+    #pragma HLS INTERFACE s_axilite port=hls_register_section bundle=control
+    #pragma HLS INTERFACE s_axilite port=return bundle=control
+
+    hls_pipeline<HLS_TOP_DATA_BITWIDTH, HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC, HLS_TOP_MAX_WIDTH>(input_stream, output_stream, hls_register_section);
+}
+
+
+// free-running multi-frame top (set_top hls_top_stream instead), started once with ap_ctrl_none,
+// frames are delimited by SOF / EOL and the registers apply from the next frame boundary
+void hls_top_stream(
+    hls_stream_t<HlsAxisPack<HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC>::beat_t>& input_stream,
+    hls_stream_t<HlsAxisPack<HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC>::beat_t>& output_stream,
+    const HlsRegisterSection& hls_register_section
+) {
+    #pragma HLS INTERFACE axis port=input_stream
+    #pragma HLS INTERFACE axis port=output_stream
+    #pragma HLS INTERFACE s_axilite port=hls_register_section bundle=control
+    #pragma HLS INTERFACE ap_ctrl_none port=return
+
+    hls_pipeline_stream<HLS_TOP_DATA_BITWIDTH, HLS_TOP_DATA_BITWIDTH, HLS_TOP_PPC, HLS_TOP_MAX_WIDTH>(input_stream, output_stream, hls_register_section);
+}
@@ -14,11 +14,12 @@
 #include "parse_json_function.h"
 #include "print_function.h"
 #include "vector_function.h"
+#include "hash_manifest_function.h"
 
 // ip
 #include "hls_info.h"
-#include "hls_crop.h"
-// #include "hls_dpc.h"
+#include "hls_axis_pack.h"
+#include "hls_pipeline.h"
 
 // using
 using json = nlohmann::json;
@@ -32,7 +33,8 @@ using namespace hls;
 #define HLS_DPC_OUTPUT_DATA_BITWIDTH    HLS_OUTPUT_DATA_BITWIDTH
 
 
-template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE, int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH>
+// HLS_PPC pixels per beat, packed as HlsAxisPack (e.g. 3x10 bit in a 32 bit TDATA)
+template <typename ALG_INPUT_DATA_TYPE, typename ALG_OUTPUT_DATA_TYPE, int HLS_INPUT_DATA_BITWIDTH, int HLS_OUTPUT_DATA_BITWIDTH, int HLS_PPC = 1>
 class HlsTop {
 public:
     HlsTop() {};
@@ -51,32 +53,37 @@ public:
 
     // data object
     vector<ALG_INPUT_DATA_TYPE> hls_input_image;
+    vector<ALG_OUTPUT_DATA_TYPE> hls_dpc_output_image;
     vector<ALG_OUTPUT_DATA_TYPE> hls_output_image;
+    bool hls_dpc_stage_enable = false;      // dpc ahead of crop, off: dpc bypassed as in AlgTop (alg_dpc_stage_enable)
+    bool hls_stage_output_enable = false;   // also run the pipeline with crop bypassed for hls_dpc_output_image
+    bool hls_framing_ok = true;
     
-    // ip object
-    HlsCrop<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH> hls_crop;
-    // HlsDpc<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH> hls_dpc;
+    // ip object: dpc -> crop, see hls_pipeline.h (hls_top.cpp is the synthesis top)
+    // owned here, so the line buffers live and die with this HlsTop (one per fuzz worker)
+    HlsPipelineKernel<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC> hls_pipeline_kernel;
 
 
     // section operation
     void loadRegisterSection(const RegisterSection& register_section) {
         MAIN_INFO_1("Register Section loading...");
-        hls_register_section.reg_image_width = ap_uint<16>(register_section.reg_map["reg_image_width"]);
-        hls_register_section.reg_image_height = ap_uint<16>(register_section.reg_map["reg_image_height"]);
-        hls_register_section.reg_crop_enable = (register_section.reg_map["reg_crop_enable"] > 0) ? ap_uint<1>(1) : ap_uint<1>(0);
-        hls_register_section.reg_crop_start_x = ap_uint<16>(static_cast<unsigned short>(register_section.reg_map["reg_crop_start_x"]));
-        hls_register_section.reg_crop_start_y = ap_uint<16>(static_cast<unsigned short>(register_section.reg_map["reg_crop_start_y"]));
-        hls_register_section.reg_crop_end_x = ap_uint<16>(static_cast<unsigned short>(register_section.reg_map["reg_crop_end_x"]));
-        hls_register_section.reg_crop_end_y = ap_uint<16>(static_cast<unsigned short>(register_section.reg_map["reg_crop_end_y"]));
-        hls_register_section.reg_dpc_enable = (register_section.reg_map["reg_dpc_enable"] > 0) ? ap_uint<1>(1) : ap_uint<1>(0);
-        hls_register_section.reg_dpc_threshold = ap_uint<16>(static_cast<unsigned short>(register_section.reg_map["reg_dpc_threshold"]));
+        hls_register_section.reg_image_width = ap_uint<16>(register_section.value("reg_image_width"));
+        hls_register_section.reg_image_height = ap_uint<16>(register_section.value("reg_image_height"));
+        hls_register_section.reg_crop_enable = (register_section.value("reg_crop_enable") > 0) ? ap_uint<1>(1) : ap_uint<1>(0);
+        hls_register_section.reg_crop_start_x = ap_uint<16>(static_cast<unsigned short>(register_section.value("reg_crop_start_x")));
+        hls_register_section.reg_crop_start_y = ap_uint<16>(static_cast<unsigned short>(register_section.value("reg_crop_start_y")));
+        hls_register_section.reg_crop_end_x = ap_uint<16>(static_cast<unsigned short>(register_section.value("reg_crop_end_x")));
+        hls_register_section.reg_crop_end_y = ap_uint<16>(static_cast<unsigned short>(register_section.value("reg_crop_end_y")));
+        hls_register_section.reg_dpc_enable = (register_section.value("reg_dpc_enable") > 0) ? ap_uint<1>(1) : ap_uint<1>(0);
+        hls_register_section.reg_dpc_threshold = ap_uint<16>(static_cast<unsigned short>(register_section.value("reg_dpc_threshold")));
     }
 
-    void loadImageSection(const ImageSection& image_section) {
+    // the source image paths live in output_info next to the other data paths
+    void loadImageSection(const ImageSection& image_section, const OutputSection& output_section) {
         MAIN_INFO_1("Image Section loading...");
-        hls_image_section.image_path = image_section.image_path;
-        hls_image_section.random_image_path = image_section.random_image_path;
-        hls_image_section.generate_random_image = image_section.generate_random_image;
+        hls_image_section.image_path = output_section.src_image_path;
+        hls_image_section.random_image_path = output_section.random_src_image_path;
+        hls_image_section.generate_random_image = image_section.generate_random_src_image_enable;
     }
 
     void loadOutputSection(const OutputSection& output_section) {
@@ -89,7 +96,7 @@ public:
 
     void loadSection(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
         loadRegisterSection(register_section);
-        loadImageSection(image_section);
+        loadImageSection(image_section, output_section);
         loadOutputSection(output_section);
     }
 
@@ -164,6 +171,40 @@ public:
     //     return data;
     // }
 
+    int getOutputWidth() const {
+        if (!hls_register_section.reg_crop_enable) {
+            return hls_register_section.reg_image_width;
+        }
+        return hls_register_section.reg_crop_end_x - hls_register_section.reg_crop_start_x + 1;
+    }
+
+    int getOutputHeight() const {
+        if (!hls_register_section.reg_crop_enable) {
+            return hls_register_section.reg_image_height;
+        }
+        return hls_register_section.reg_crop_end_y - hls_register_section.reg_crop_start_y + 1;
+    }
+
+    // one frame through hls_pipeline in memory, no file I/O
+    // without hls_dpc_stage_enable the pipeline runs with reg_dpc_enable cleared, so the default flow is
+    // crop-only like AlgTop, the synthesis top (hls_top.cpp) keeps following reg_dpc_enable
+    // the DPC stage is not visible outside the DATAFLOW region, with hls_stage_output_enable the
+    // frame runs a second time with crop bypassed, which leaves exactly the DPC output on the stream
+    template <typename IMAGE>
+    void process(const IMAGE& input_image) {
+        hls_framing_ok = true;
+        HlsRegisterSection stage_register_section = hls_register_section;
+        if (!hls_dpc_stage_enable) {
+            stage_register_section.reg_dpc_enable = 0;
+            hls_dpc_output_image.clear();
+        } else if (hls_stage_output_enable) {
+            HlsRegisterSection dpc_register_section = hls_register_section;
+            dpc_register_section.reg_crop_enable = 0;
+            runPipeline(input_image, dpc_register_section, hls_register_section.reg_image_width, hls_register_section.reg_image_height, hls_dpc_output_image);
+        }
+        runPipeline(input_image, stage_register_section, getOutputWidth(), getOutputHeight(), hls_output_image);
+    }
+
     void run(RegisterSection& register_section, const ImageSection& image_section, const OutputSection& output_section) {
         // hls initialize
         MAIN_INFO_1("hls initialize...");
@@ -172,28 +213,49 @@ public:
         loadImage();
 
         // hls run
-        MAIN_INFO_1("hls run...");      
-        // data object
-        hls::stream<ap_axiu<HLS_INPUT_DATA_BITWIDTH, 0, 0, 0>> hls_input_stream;
-        hls::stream<ap_axiu<HLS_OUTPUT_DATA_BITWIDTH, 0, 0, 0>> hls_output_stream;
-
-        MAIN_INFO_1("hls crop run simulation (skipping actual HLS code)...");
-
-        vector_to_stream(hls_input_image, hls_input_stream);
-        hls_crop.run(hls_input_stream, hls_output_stream, hls_register_section);
-        stream_to_vector(hls_output_stream, hls_output_image);
+        MAIN_INFO_1("hls run...");
+        MAIN_INFO_1(string("hls pipeline (") + (hls_dpc_stage_enable ? "dpc -> crop" : "crop") + ") run simulation, " + to_string(HLS_PPC) + "x" + to_string(HLS_INPUT_DATA_BITWIDTH)
+                    + " bit pixels per " + to_string(HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC>::BEAT_BITS) + " bit beat...");
+        HlsDpc<HLS_INPUT_DATA_BITWIDTH, HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC>::report_memory();
+        process(hls_input_image);
+        int crop_image_width = getOutputWidth();
+        int crop_image_height = getOutputHeight();
+        if (!hls_framing_ok) {
+            MAIN_INFO_1("Warning: hls output stream framing does not match the " + to_string(crop_image_width) + "x" + to_string(crop_image_height) + " output frame");
+        }
 
         // Write output to file
-        int crop_image_width = hls_register_section.reg_crop_end_x-hls_register_section.reg_crop_start_x+1;
-        int crop_image_height = hls_register_section.reg_crop_end_y-hls_register_section.reg_crop_start_y+1;
+        if (hls_dpc_stage_enable && hls_stage_output_enable) {
+            MAIN_INFO_1("hls dpc output data save to: " + hls_output_section.hls_dpc_output_path);
+            vector_write_to_file(hls_output_section.hls_dpc_output_path, hls_dpc_output_image, hls_register_section.reg_image_width, hls_register_section.reg_image_height);
+            hash_manifest_write_for(hls_output_section.hls_dpc_output_path, hls_dpc_output_image, hls_register_section.reg_image_width, hls_register_section.reg_image_height);
+        } else {
+            hash_manifest_remove_for(hls_output_section.hls_dpc_output_path);
+        }
         MAIN_INFO_1("hls crop output image width: " + std::to_string(crop_image_width));
         MAIN_INFO_1("hls crop output image height: " + std::to_string(crop_image_height));
         vector_write_to_file(hls_output_section.hls_crop_output_path, hls_output_image, crop_image_width, crop_image_height);
+        hash_manifest_write_for(hls_output_section.hls_crop_output_path, hls_output_image, crop_image_width, crop_image_height);
         MAIN_INFO_1("hls crop output data save to: " + hls_output_section.hls_crop_output_path);
         MAIN_INFO_1("hls run completed");
     }
 
 
+private:
+    template <typename IMAGE>
+    void runPipeline(const IMAGE& input_image, const HlsRegisterSection& register_section, int output_width, int output_height,
+                     vector<ALG_OUTPUT_DATA_TYPE>& output_image) {
+        typedef HlsAxisPack<HLS_INPUT_DATA_BITWIDTH, HLS_PPC> input_pack_t;
+        typedef HlsAxisPack<HLS_OUTPUT_DATA_BITWIDTH, HLS_PPC> output_pack_t;
+        hls_stream_t<typename input_pack_t::beat_t> hls_input_stream;
+        hls_stream_t<typename output_pack_t::beat_t> hls_output_stream;
+        hls_stream_reserve(hls_output_stream, (size_t)((output_width + HLS_PPC - 1) / HLS_PPC) * output_height);
+
+        input_pack_t::pack_frame(input_image, register_section.reg_image_width, register_section.reg_image_height, hls_input_stream);
+        hls_pipeline(hls_input_stream, hls_output_stream, register_section, hls_pipeline_kernel);
+        hls_framing_ok &= output_pack_t::unpack_frame(hls_output_stream, output_width, output_height, output_image) && hls_output_stream.empty();
+    }
+
 };
 
 
@@ -0,0 +1,167 @@
+#ifndef IMAGE_PREFETCHER_H
+#define IMAGE_PREFETCHER_H
+
+// std
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+
+// posix
+#include <fcntl.h>
+#include <unistd.h>
+
+// tool
+#include "print_function.h"
+#include "vector_function.h"
+#include "frame_buffer_pool.h"
+
+// def
+#define IMAGE_PREFETCHER_SECTION        "ImagePrefetcher"
+#define IMAGE_PREFETCHER_QUEUE_DEPTH    2
+#define IMAGE_PREFETCHER_MEMORY_BUDGET  (256u << 20)
+
+// using
+using namespace std;
+
+
+// reads and decodes the next queue_depth input frames on a background thread
+// while the caller processes the current one
+//  - at most queue_depth decoded frames wait in the queue
+//  - decoding pauses while the queued frames exceed memory_budget bytes (one frame is always allowed)
+//  - files further ahead get a posix_fadvise(WILLNEED) hint so the page cache / NFS client reads ahead
+//  - the worker never exits the process: every path is checked up front on the caller's thread, and a
+//    file that still fails to open later is reported by next(), after the frames queued before it
+template <typename T>
+class ImagePrefetcher {
+public:
+    ImagePrefetcher(const vector<string>& path_list, int queue_depth = IMAGE_PREFETCHER_QUEUE_DEPTH, size_t memory_budget = IMAGE_PREFETCHER_MEMORY_BUDGET)
+        : prefetch_path_list(path_list),
+          prefetch_queue_depth(queue_depth > 0 ? queue_depth : 1),
+          prefetch_memory_budget(memory_budget),
+          prefetch_queue_bytes(0),
+          prefetch_stop(false),
+          prefetch_done(false),
+          prefetch_wait_count(0) {
+        for (size_t i = 0; i < prefetch_path_list.size(); i++) {
+            if (access(prefetch_path_list[i].c_str(), R_OK) != 0) {
+                MAIN_ERROR_1("Cannot open input file: " + prefetch_path_list[i]);
+            }
+        }
+        prefetch_thread = thread(&ImagePrefetcher::worker, this);
+    }
+
+    ~ImagePrefetcher() {
+        {
+            lock_guard<mutex> lock(prefetch_mutex);
+            prefetch_stop = true;
+        }
+        prefetch_cv.notify_all();
+        prefetch_thread.join();
+    }
+
+    // blocks until the next frame is decoded, returns false after the last frame
+    bool next(frame_vector<T>& image, string& path) {
+        unique_lock<mutex> lock(prefetch_mutex);
+        if (prefetch_queue.empty() && !prefetch_done) {
+            prefetch_wait_count++;
+        }
+        prefetch_cv.wait(lock, [this]() { return !prefetch_queue.empty() || prefetch_done; });
+        if (prefetch_queue.empty()) {
+            if (!prefetch_error_path.empty()) {
+                MAIN_ERROR_1("Cannot open input file: " + prefetch_error_path);
+            }
+            return false;
+        }
+        path = prefetch_queue.front().first;
+        image.swap(prefetch_queue.front().second);
+        prefetch_queue_bytes -= image.size() * sizeof(T);
+        prefetch_queue.pop_front();
+        lock.unlock();
+        prefetch_cv.notify_all();
+        return true;
+    }
+
+    // number of next() calls that had to wait on I/O
+    size_t waitCount() const {
+        lock_guard<mutex> lock(prefetch_mutex);
+        return prefetch_wait_count;
+    }
+
+private:
+    void worker() {
+        for (size_t i = 0; i < prefetch_path_list.size(); i++) {
+            // keep a read-ahead hint on the next 2*queue_depth files
+            size_t advise_depth = 2 * prefetch_queue_depth;
+            if (i == 0) {
+                for (size_t j = 0; j < advise_depth && j < prefetch_path_list.size(); j++) {
+                    adviseWillNeed(prefetch_path_list[j]);
+                }
+            } else if (i + advise_depth - 1 < prefetch_path_list.size()) {
+                adviseWillNeed(prefetch_path_list[i + advise_depth - 1]);
+            }
+
+            {
+                unique_lock<mutex> lock(prefetch_mutex);
+                prefetch_cv.wait(lock, [this]() {
+                    return prefetch_stop ||
+                           (prefetch_queue.size() < (size_t)prefetch_queue_depth &&
+                            (prefetch_queue.empty() || prefetch_queue_bytes < prefetch_memory_budget));
+                });
+                if (prefetch_stop) {
+                    break;
+                }
+            }
+
+            frame_vector<T> image;
+            if (!vector_try_read_from_file(prefetch_path_list[i], image)) {
+                lock_guard<mutex> lock(prefetch_mutex);
+                prefetch_error_path = prefetch_path_list[i];
+                break;
+            }
+
+            {
+                lock_guard<mutex> lock(prefetch_mutex);
+                prefetch_queue_bytes += image.size() * sizeof(T);
+                prefetch_queue.push_back(make_pair(prefetch_path_list[i], frame_vector<T>()));
+                prefetch_queue.back().second.swap(image);
+            }
+            prefetch_cv.notify_all();
+        }
+
+        {
+            lock_guard<mutex> lock(prefetch_mutex);
+            prefetch_done = true;
+        }
+        prefetch_cv.notify_all();
+    }
+
+    static void adviseWillNeed(const string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+        close(fd);
+    }
+
+    vector<string> prefetch_path_list;
+    int prefetch_queue_depth;
+    size_t prefetch_memory_budget;
+
+    mutable mutex prefetch_mutex;
+    condition_variable prefetch_cv;
+    deque<pair<string, frame_vector<T>>> prefetch_queue;
+    size_t prefetch_queue_bytes;
+    bool prefetch_stop;
+    bool prefetch_done;
+    string prefetch_error_path;     // file the worker failed to read, reported by next()
+    size_t prefetch_wait_count;
+    thread prefetch_thread;
+};
+
+
+#endif // IMAGE_PREFETCHER_H
@@ -0,0 +1,436 @@
+#ifndef METRICS_FUNCTION_H
+#define METRICS_FUNCTION_H
+
+// image quality metrics of an output against a reference, per Bayer channel and over the frame
+//  - PSNR (peak 2^bitwidth - 1), MSE, max abs error and differing sample count, one pass over bands
+//    of rows, even / odd columns in two branch free accumulators so the loop vectorizes
+//  - SSIM on each CFA plane (every other row / column), 8x8 windows at stride 4 with integer
+//    window sums (C1 = (0.01 L)^2, C2 = (0.03 L)^2): plane samples are read into 4x4 block sums
+//    (once, plus one shared block row per chunk of window rows), a window is the sum of 2x2 blocks
+//  - works on any sample pointers: in memory frames, mmapped raw dumps or parsed text dumps
+//    (loaders of compare_function.h), metrics_to_json gives the machine readable result
+// channel c = ((y & 1) << 1) | (x & 1), named after the CFA pattern (rggb: r, gr, gb, b)
+
+// std
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <utility>
+
+// tool
+#include "json.hpp"
+#include "print_function.h"
+#include "compare_function.h"
+
+// def
+#define METRICS_FUNCTION_SECTION    "[metrics_function]"
+#define METRICS_CHANNEL_NUM         4
+#define METRICS_BAND_ROWS           64
+#define METRICS_SSIM_WINDOW         8
+#define METRICS_SSIM_CHUNK_ROWS     16      // window rows per task
+#define METRICS_SSIM_SEGMENT_BLOCKS 256     // blocks per column segment of a block row
+#define METRICS_PSNR_MAX            100.0   // PSNR of identical frames, JSON has no inf
+
+// using
+using json = nlohmann::json;
+using namespace std;
+
+
+struct MetricsOption {
+    int thread_num = 0;                 // 0: hardware concurrency
+    int width = 0;                      // 0: from the coordinate comments of text dumps, else one row
+    int radix = 16;                     // text values, 16 or 10
+    int sample_bytes = 2;               // raw binary samples, 1 or 2
+    int bitwidth = 0;                   // 0: smallest of 8/10/12/14/16 bit holding both frames
+    string bayer = "rggb";              // channel names only
+    bool ssim_enable = true;
+};
+
+struct MetricsChannel {
+    string name;
+    uint64_t sample_num = 0;
+    uint64_t mismatch_num = 0;
+    uint64_t sse = 0;
+    uint32_t max_abs_diff = 0;
+    double mse = 0;
+    double psnr = METRICS_PSNR_MAX;
+    double ssim = 1.0;
+    double ssim_sum = 0;
+    uint64_t ssim_window_num = 0;
+};
+
+struct MetricsResult {
+    bool load_ok = false;
+    size_t alg_size = 0;
+    size_t hls_size = 0;
+    int width = 0;
+    int height = 0;
+    int bitwidth = 0;
+    MetricsChannel channel[METRICS_CHANNEL_NUM];
+    MetricsChannel total;
+    double second = 0;
+
+    bool same_size() const { return alg_size == hls_size; }
+};
+
+
+// channel names of a 2x2 CFA pattern, the greens are named after the other color of their row
+inline void metrics_channel_name(const string& bayer, MetricsResult& result) {
+    string pattern = bayer.size() == 4 ? bayer : string("rggb");
+    for (int c = 0; c < METRICS_CHANNEL_NUM; c++) {
+        char color = (char)tolower((unsigned char)pattern[c]);
+        result.channel[c].name = string(1, color);
+        if (color == 'g') {
+            result.channel[c].name += (char)tolower((unsigned char)pattern[c ^ 1]);
+        }
+    }
+    result.total.name = "all";
+}
+
+inline void metrics_finish_channel(MetricsChannel& channel, double peak) {
+    channel.mse = channel.sample_num ? (double)channel.sse / channel.sample_num : 0.0;
+    channel.psnr = (channel.mse > 0) ? min(METRICS_PSNR_MAX, 10.0 * log10(peak * peak / channel.mse)) : METRICS_PSNR_MAX;
+    channel.ssim = channel.ssim_window_num ? channel.ssim_sum / channel.ssim_window_num : 1.0;
+}
+
+
+inline void metrics_accumulate(int32_t av, int32_t bv, uint64_t& sse, uint32_t& mismatch, uint32_t& max_diff, uint32_t& max_value) {
+    int32_t d = av - bv;
+    uint32_t ad = (uint32_t)(d < 0 ? -d : d);
+    sse += (uint64_t)((int64_t)d * d);
+    mismatch += (ad != 0);
+    max_diff = max(max_diff, ad);
+    max_value = max(max_value, (uint32_t)max(av, bv));
+}
+
+// squared error / max error / mismatch count of rows [y_begin, y_end) per channel, max sample in max_value
+template <typename A, typename B>
+void metrics_error_band(const A* alg, const B* hls, int width, int y_begin, int y_end, MetricsChannel* channel, uint32_t& max_value) {
+    for (int y = y_begin; y < y_end; y++) {
+        const A* a = alg + (size_t)y * width;
+        const B* b = hls + (size_t)y * width;
+        uint64_t even_sse = 0, odd_sse = 0;
+        uint32_t even_mismatch = 0, odd_mismatch = 0;
+        uint32_t even_max = 0, odd_max = 0;
+        uint32_t row_max = 0;
+        int pair_num = width / 2;
+        for (int p = 0; p < pair_num; p++) {
+            metrics_accumulate((int32_t)a[2 * p], (int32_t)b[2 * p], even_sse, even_mismatch, even_max, row_max);
+            metrics_accumulate((int32_t)a[2 * p + 1], (int32_t)b[2 * p + 1], odd_sse, odd_mismatch, odd_max, row_max);
+        }
+        if (width & 1) {
+            metrics_accumulate((int32_t)a[width - 1], (int32_t)b[width - 1], even_sse, even_mismatch, even_max, row_max);
+        }
+
+        MetricsChannel& even = channel[(y & 1) << 1];
+        MetricsChannel& odd = channel[((y & 1) << 1) | 1];
+        even.sse += even_sse;
+        even.mismatch_num += even_mismatch;
+        even.max_abs_diff = max(even.max_abs_diff, even_max);
+        even.sample_num += (width + 1) / 2;
+        odd.sse += odd_sse;
+        odd.mismatch_num += odd_mismatch;
+        odd.max_abs_diff = max(odd.max_abs_diff, odd_max);
+        odd.sample_num += width / 2;
+        max_value = max(max_value, row_max);
+    }
+}
+
+// window sums of one SSIM block, a window is window_blocks x window_blocks blocks
+struct MetricsSsimBlock {
+    int64_t a;
+    int64_t b;
+    int64_t aa;
+    int64_t bb;
+    int64_t ab;
+};
+
+// SSIM geometry of one CFA plane: 4x4 blocks, 8x8 windows = 2x2 blocks at stride 4; a plane side
+// below 8 samples is one block / one window
+struct MetricsSsimPlane {
+    int px = 0;
+    int py = 0;
+    int block_w = 0;
+    int block_h = 0;
+    int block_cols = 0;
+    int block_rows = 0;
+    int window_blocks_x = 0;
+    int window_blocks_y = 0;
+
+    void init(int c, int width, int height) {
+        px = c & 1;
+        py = c >> 1;
+        int plane_width = (width - px + 1) / 2;
+        int plane_height = (height - py + 1) / 2;
+        int half = METRICS_SSIM_WINDOW / 2;
+        block_w = (plane_width >= METRICS_SSIM_WINDOW) ? half : plane_width;
+        block_h = (plane_height >= METRICS_SSIM_WINDOW) ? half : plane_height;
+        block_cols = block_w ? plane_width / block_w : 0;
+        block_rows = block_h ? plane_height / block_h : 0;
+        window_blocks_x = (plane_width >= METRICS_SSIM_WINDOW) ? 2 : 1;
+        window_blocks_y = (plane_height >= METRICS_SSIM_WINDOW) ? 2 : 1;
+    }
+
+    int window_rows() const { return max(0, block_rows - window_blocks_y + 1); }
+};
+
+// block sums of block row block_y into block[0 .. block_cols), in segments of
+// METRICS_SSIM_SEGMENT_BLOCKS blocks: the plane rows of a segment are gathered into contiguous
+// buffers, summed column wise (vectorized), then per block
+template <typename A, typename B>
+void metrics_ssim_block_row(const A* alg, const B* hls, int width, const MetricsSsimPlane& plane, int block_y, MetricsSsimBlock* block) {
+    int segment_width = METRICS_SSIM_SEGMENT_BLOCKS * plane.block_w;
+    vector<int64_t> sum_a(segment_width);
+    vector<int64_t> sum_b(segment_width);
+    vector<int64_t> sum_aa(segment_width);
+    vector<int64_t> sum_bb(segment_width);
+    vector<int64_t> sum_ab(segment_width);
+    vector<int32_t> row_a(segment_width);
+    vector<int32_t> row_b(segment_width);
+    for (int bx0 = 0; bx0 < plane.block_cols; bx0 += METRICS_SSIM_SEGMENT_BLOCKS) {
+        int bx1 = min(plane.block_cols, bx0 + METRICS_SSIM_SEGMENT_BLOCKS);
+        int n = (bx1 - bx0) * plane.block_w;
+        fill(sum_a.begin(), sum_a.end(), 0);
+        fill(sum_b.begin(), sum_b.end(), 0);
+        fill(sum_aa.begin(), sum_aa.end(), 0);
+        fill(sum_bb.begin(), sum_bb.end(), 0);
+        fill(sum_ab.begin(), sum_ab.end(), 0);
+        for (int i = 0; i < plane.block_h; i++) {
+            size_t row_start = (size_t)(plane.py + 2 * (block_y * plane.block_h + i)) * width + plane.px + 2 * (size_t)bx0 * plane.block_w;
+            for (int x = 0; x < n; x++) {
+                row_a[x] = (int32_t)alg[row_start + 2 * (size_t)x];
+                row_b[x] = (int32_t)hls[row_start + 2 * (size_t)x];
+            }
+            for (int x = 0; x < n; x++) {
+                int64_t av = row_a[x];
+                int64_t bv = row_b[x];
+                sum_a[x] += av;
+                sum_b[x] += bv;
+                sum_aa[x] += av * av;
+                sum_bb[x] += bv * bv;
+                sum_ab[x] += av * bv;
+            }
+        }
+        for (int bx = bx0; bx < bx1; bx++) {
+            MetricsSsimBlock sum = {0, 0, 0, 0, 0};
+            for (int x = (bx - bx0) * plane.block_w; x < (bx - bx0 + 1) * plane.block_w; x++) {
+                sum.a += sum_a[x];
+                sum.b += sum_b[x];
+                sum.aa += sum_aa[x];
+                sum.bb += sum_bb[x];
+                sum.ab += sum_ab[x];
+            }
+            block[bx] = sum;
+        }
+    }
+}
+
+// SSIM of the windows of window rows [window_y_begin, window_y_end), summed into channel; the block
+// rows they need are computed into a local buffer, neighbouring chunks share one block row
+template <typename A, typename B>
+void metrics_ssim_window_rows(const A* alg, const B* hls, int width, const MetricsSsimPlane& plane, int window_y_begin,
+                              int window_y_end, double c1, double c2, MetricsChannel& channel) {
+    int block_row_num = window_y_end - window_y_begin + plane.window_blocks_y - 1;
+    vector<MetricsSsimBlock> block((size_t)block_row_num * plane.block_cols);
+    for (int r = 0; r < block_row_num; r++) {
+        metrics_ssim_block_row(alg, hls, width, plane, window_y_begin + r, &block[(size_t)r * plane.block_cols]);
+    }
+
+    double n = (double)plane.window_blocks_x * plane.block_w * plane.window_blocks_y * plane.block_h;
+    for (int r = 0; r < window_y_end - window_y_begin; r++) {
+        for (int wx = 0; wx + plane.window_blocks_x <= plane.block_cols; wx++) {
+            MetricsSsimBlock sum = {0, 0, 0, 0, 0};
+            for (int by = r; by < r + plane.window_blocks_y; by++) {
+                const MetricsSsimBlock* row = &block[(size_t)by * plane.block_cols + wx];
+                for (int bx = 0; bx < plane.window_blocks_x; bx++) {
+                    sum.a += row[bx].a;
+                    sum.b += row[bx].b;
+                    sum.aa += row[bx].aa;
+                    sum.bb += row[bx].bb;
+                    sum.ab += row[bx].ab;
+                }
+            }
+            double mu_a = sum.a / n;
+            double mu_b = sum.b / n;
+            double var_a = sum.aa / n - mu_a * mu_a;
+            double var_b = sum.bb / n - mu_b * mu_b;
+            double cov = sum.ab / n - mu_a * mu_b;
+            channel.ssim_sum += ((2 * mu_a * mu_b + c1) * (2 * cov + c2)) / ((mu_a * mu_a + mu_b * mu_b + c1) * (var_a + var_b + c2));
+            channel.ssim_window_num++;
+        }
+    }
+}
+
+// metrics of the first min(alg_size, hls_size) samples as a width x height frame (whole rows only)
+template <typename A, typename B>
+MetricsResult metrics_image(const A* alg, size_t alg_size, const B* hls, size_t hls_size, const MetricsOption& option) {
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    MetricsResult result;
+    metrics_channel_name(option.bayer, result);
+    size_t size = min(alg_size, hls_size);
+    result.alg_size = alg_size;
+    result.hls_size = hls_size;
+    result.width = (option.width > 0) ? option.width : (int)max<size_t>(1, size);
+    result.height = (int)(size / result.width);
+    result.load_ok = true;
+
+    // errors, bands of rows
+    size_t band_num = ((size_t)result.height + METRICS_BAND_ROWS - 1) / METRICS_BAND_ROWS;
+    vector<MetricsChannel> band_channel(band_num * METRICS_CHANNEL_NUM);
+    vector<uint32_t> band_max(band_num, 0);
+    compare_parallel_for(band_num, option.thread_num, [&](size_t band) {
+        int y_begin = (int)band * METRICS_BAND_ROWS;
+        int y_end = min(result.height, y_begin + METRICS_BAND_ROWS);
+        metrics_error_band(alg, hls, result.width, y_begin, y_end, &band_channel[band * METRICS_CHANNEL_NUM], band_max[band]);
+    });
+    uint32_t max_value = 0;
+    for (size_t band = 0; band < band_num; band++) {
+        max_value = max(max_value, band_max[band]);
+        for (int c = 0; c < METRICS_CHANNEL_NUM; c++) {
+            const MetricsChannel& part = band_channel[band * METRICS_CHANNEL_NUM + c];
+            result.channel[c].sample_num += part.sample_num;
+            result.channel[c].mismatch_num += part.mismatch_num;
+            result.channel[c].sse += part.sse;
+            result.channel[c].max_abs_diff = max(result.channel[c].max_abs_diff, part.max_abs_diff);
+        }
+    }
+    result.bitwidth = option.bitwidth;
+    if (result.bitwidth <= 0) {
+        result.bitwidth = 8;
+        while (result.bitwidth < 16 && max_value >= (1u << result.bitwidth)) {
+            result.bitwidth += 2;
+        }
+    }
+    double peak = (double)((1u << result.bitwidth) - 1);
+
+    // SSIM, one task per chunk of METRICS_SSIM_CHUNK_ROWS window rows of a plane
+    if (option.ssim_enable) {
+        double c1 = (0.01 * peak) * (0.01 * peak);
+        double c2 = (0.03 * peak) * (0.03 * peak);
+        MetricsSsimPlane plane[METRICS_CHANNEL_NUM];
+        vector<pair<int, int>> task_list;
+        for (int c = 0; c < METRICS_CHANNEL_NUM; c++) {
+            plane[c].init(c, result.width, result.height);
+            for (int y = 0; y < plane[c].window_rows(); y += METRICS_SSIM_CHUNK_ROWS) {
+                task_list.push_back(make_pair(c, y));
+            }
+        }
+        vector<MetricsChannel> task_channel(task_list.size());
+        compare_parallel_for(task_list.size(), option.thread_num, [&](size_t t) {
+            const MetricsSsimPlane& task_plane = plane[task_list[t].first];
+            int y_begin = task_list[t].second;
+            int y_end = min(task_plane.window_rows(), y_begin + METRICS_SSIM_CHUNK_ROWS);
+            metrics_ssim_window_rows(alg, hls, result.width, task_plane, y_begin, y_end, c1, c2, task_channel[t]);
+        });
+        for (size_t t = 0; t < task_list.size(); t++) {
+            result.channel[task_list[t].first].ssim_sum += task_channel[t].ssim_sum;
+            result.channel[task_list[t].first].ssim_window_num += task_channel[t].ssim_window_num;
+        }
+    }
+
+    for (int c = 0; c < METRICS_CHANNEL_NUM; c++) {
+        metrics_finish_channel(result.channel[c], peak);
+        result.total.sample_num += result.channel[c].sample_num;
+        result.total.mismatch_num += result.channel[c].mismatch_num;
+        result.total.sse += result.channel[c].sse;
+        result.total.max_abs_diff = max(result.total.max_abs_diff, result.channel[c].max_abs_diff);
+        result.total.ssim_sum += result.channel[c].ssim_sum;
+        result.total.ssim_window_num += result.channel[c].ssim_window_num;
+    }
+    metrics_finish_channel(result.total, peak);
+    result.second = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    return result;
+}
+
+
+// alg_path vs hls_path, text or raw binary by extension (same loaders as compare_file)
+inline MetricsResult metrics_file(const string& alg_path, const string& hls_path, const MetricsOption& option) {
+    MappedFile alg_file;
+    MappedFile hls_file;
+    if (!alg_file.open(alg_path)) {
+        main_info(METRICS_FUNCTION_SECTION, "Cannot open file: " + alg_path);
+        return MetricsResult();
+    }
+    if (!hls_file.open(hls_path)) {
+        main_info(METRICS_FUNCTION_SECTION, "Cannot open file: " + hls_path);
+        return MetricsResult();
+    }
+
+    if (compare_is_raw_path(alg_path) && compare_is_raw_path(hls_path)) {
+        if (option.sample_bytes == 1) {
+            return metrics_image(reinterpret_cast<const uint8_t*>(alg_file.data), alg_file.size,
+                                 reinterpret_cast<const uint8_t*>(hls_file.data), hls_file.size, option);
+        }
+        return metrics_image(reinterpret_cast<const uint16_t*>(alg_file.data), alg_file.size / 2,
+                             reinterpret_cast<const uint16_t*>(hls_file.data), hls_file.size / 2, option);
+    }
+
+    vector<int32_t> alg_value;
+    vector<int32_t> hls_value;
+    std::thread alg_loader([&]() { compare_load_text(alg_file, option.radix, option.thread_num, alg_value); });
+    compare_load_text(hls_file, option.radix, option.thread_num, hls_value);
+    alg_loader.join();
+    MetricsOption file_option = option;
+    if (file_option.width <= 0) {
+        file_option.width = compare_text_width(alg_file.data, alg_file.size);
+    }
+    return metrics_image(alg_value.data(), alg_value.size(), hls_value.data(), hls_value.size(), file_option);
+}
+
+
+inline json metrics_channel_json(const MetricsChannel& channel) {
+    json channel_json;
+    channel_json["samples"] = channel.sample_num;
+    channel_json["mismatches"] = channel.mismatch_num;
+    channel_json["max_abs_diff"] = channel.max_abs_diff;
+    channel_json["mse"] = channel.mse;
+    channel_json["psnr"] = channel.psnr;
+    channel_json["ssim"] = channel.ssim;
+    return channel_json;
+}
+
+inline json metrics_to_json(const MetricsResult& result) {
+    json result_json;
+    result_json["load_ok"] = result.load_ok;
+    result_json["alg_samples"] = result.alg_size;
+    result_json["hls_samples"] = result.hls_size;
+    result_json["width"] = result.width;
+    result_json["height"] = result.height;
+    result_json["bitwidth"] = result.bitwidth;
+    result_json["all"] = metrics_channel_json(result.total);
+    for (int c = 0; c < METRICS_CHANNEL_NUM; c++) {
+        result_json["channel"][result.channel[c].name] = metrics_channel_json(result.channel[c]);
+    }
+    result_json["second"] = result.second;
+    return result_json;
+}
+
+inline void metrics_print(const string& section, const string& name, const MetricsResult& result) {
+    char line[512];
+    if (!result.load_ok) {
+        snprintf(line, sizeof(line), "%s: cannot load", name.c_str());
+        main_info(section, line);
+        return;
+    }
+    snprintf(line, sizeof(line), "%s: %dx%d, %d bit, alg %zu / hls %zu samples%s, %.3f ms", name.c_str(), result.width,
+             result.height, result.bitwidth, result.alg_size, result.hls_size, result.same_size() ? "" : " (size differs)",
+             result.second * 1000.0);
+    main_info(section, line);
+    const MetricsChannel* channel_list[METRICS_CHANNEL_NUM + 1] = {&result.total, &result.channel[0], &result.channel[1],
+                                                                   &result.channel[2], &result.channel[3]};
+    for (int c = 0; c < METRICS_CHANNEL_NUM + 1; c++) {
+        const MetricsChannel& channel = *channel_list[c];
+        snprintf(line, sizeof(line), "  %-3s psnr %8.3f dB, ssim %.6f, mse %.6f, max abs diff %u, mismatches %llu/%llu",
+                 channel.name.c_str(), channel.psnr, channel.ssim, channel.mse, channel.max_abs_diff,
+                 (unsigned long long)channel.mismatch_num, (unsigned long long)channel.sample_num);
+        main_info(section, line);
+    }
+}
+
+
+#endif // METRICS_FUNCTION_H
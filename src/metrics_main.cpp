@@ -0,0 +1,113 @@
+// std
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <cstdlib>
+
+// tool
+#include "json.hpp"
+#include "print_function.h"
+#include "metrics_function.h"
+
+// using
+using json = nlohmann::json;
+using namespace std;
+
+// def
+#define METRICS_MAIN_SECTION        "metrics_main"
+#define METRICS_MAIN_CONFIG_PATH    "/home/sheldon/hls_project/vibe_crop/src/vibe.json"
+
+
+// usage: metrics_main [config.json | alg_file hls_file] [--threads N] [--width N] [--radix 16|10]
+//                     [--sample-bytes 1|2] [--bitwidth N] [--bayer rggb|grbg|gbrg|bggr] [--no-ssim]
+//                     [--json result.json]
+// with a config every alg_* path of output_info is scored against its hls_* pair, the result is one
+// JSON object per pair, written to --json or printed after the summary
+int main(const int argc, const char *argv[]) {
+    MetricsOption option;
+    vector<string> positional;
+    string json_path;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            option.thread_num = atoi(argv[++i]);
+        } else if (arg == "--width" && i + 1 < argc) {
+            option.width = atoi(argv[++i]);
+        } else if (arg == "--radix" && i + 1 < argc) {
+            option.radix = (atoi(argv[++i]) == 10) ? 10 : 16;
+        } else if (arg == "--sample-bytes" && i + 1 < argc) {
+            option.sample_bytes = (atoi(argv[++i]) == 1) ? 1 : 2;
+        } else if (arg == "--bitwidth" && i + 1 < argc) {
+            option.bitwidth = min(16, max(0, atoi(argv[++i])));
+        } else if (arg == "--bayer" && i + 1 < argc) {
+            option.bayer = argv[++i];
+        } else if (arg == "--no-ssim") {
+            option.ssim_enable = false;
+        } else if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (option.bayer.size() != 4) {
+        MAIN_ERROR_1("bayer pattern must have 4 colors, e.g. rggb");
+    }
+
+    // alg_xxx -> hls_xxx pairs
+    vector<string> pair_name;
+    vector<string> alg_path;
+    vector<string> hls_path;
+    if (positional.size() == 2) {
+        pair_name.push_back("image");
+        alg_path.push_back(positional[0]);
+        hls_path.push_back(positional[1]);
+    } else {
+        string config_path = positional.empty() ? string(METRICS_MAIN_CONFIG_PATH) : positional[0];
+        ifstream f(config_path);
+        if (!f.is_open()) {
+            MAIN_ERROR_1("Cannot open configuration file: " + config_path);
+        }
+        MAIN_INFO_1("configuration file path: " + config_path);
+        json data = json::parse(f);
+        f.close();
+        if (!data.contains("output_info")) {
+            MAIN_ERROR_1("output_info not found in " + config_path);
+        }
+        json output_info = data["output_info"];
+        for (json::iterator it = output_info.begin(); it != output_info.end(); ++it) {
+            const string& key = it.key();
+            string hls_key = "hls" + key.substr(min<size_t>(3, key.size()));
+            if (key.substr(0, 4) != "alg_" || !output_info.contains(hls_key)) {
+                continue;
+            }
+            pair_name.push_back(key.substr(4));
+            alg_path.push_back(it.value().get<string>());
+            hls_path.push_back(output_info[hls_key].get<string>());
+        }
+    }
+
+    json result_json;
+    for (size_t p = 0; p < pair_name.size(); p++) {
+        MAIN_INFO_1("metrics " + alg_path[p] + " vs " + hls_path[p]);
+        MetricsResult result = metrics_file(alg_path[p], hls_path[p], option);
+        metrics_print(METRICS_MAIN_SECTION, pair_name[p], result);
+        json pair_json = metrics_to_json(result);
+        pair_json["alg_path"] = alg_path[p];
+        pair_json["hls_path"] = hls_path[p];
+        result_json[pair_name[p]] = pair_json;
+    }
+
+    if (json_path.empty()) {
+        cout << result_json.dump(2) << endl;
+        return 0;
+    }
+    ofstream json_file(json_path);
+    if (!json_file.is_open()) {
+        MAIN_ERROR_1("Cannot open output file: " + json_path);
+    }
+    json_file << result_json.dump(2) << endl;
+    MAIN_INFO_1("metrics save to: " + json_path);
+    return 0;
+}
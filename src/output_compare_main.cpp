@@ -5,113 +5,134 @@
 #include <vector>
 #include <algorithm>
 #include <string>
+#include <thread>
+#include <chrono>
+
+// posix
+#include <unistd.h>
 
 // tool
 #include "json.hpp"
 #include "print_function.h"
-#include "vector_function.h"
-#include "parse_json_function.h"
+#include "compare_function.h"
 
 // using
 using json = nlohmann::json;
 using namespace std;
 
 // def
-#define ALG_INPUT_DATA_TYPE uint16_t
-#define ALG_OUTPUT_DATA_TYPE uint16_t
-#define HLS_INPUT_DATA_BITWIDTH     8
-#define HLS_OUTPUT_DATA_BITWIDTH    8
+#define OUTPUT_COMPARE_MAIN_SECTION "output_compare_main"
+#define OUTPUT_COMPARE_CONFIG_PATH  "/home/sheldon/hls_project/vibe_crop/src/vibe.json"
 
 
+// usage: output_compare_main [config.json] [--threads N] [--width N] [--radix 16|10] [--sample-bytes 1|2]
+//                            [--tile N] [--max-report N] [--no-manifest]
+// every alg_* path of output_info is compared with its hls_* pair, all pairs concurrently, pairs with
+// up to date <path>.hash manifests only read the tiles whose hashes differ
+// a pair neither model wrote (e.g. the dpc stage output without --dpc) is skipped, one missing side fails
 int main(const int argc, const char *argv[]) {
-    string config_path = "/home/sheldon/hls_project/vibe_crop/src/vibe.json";
+    string config_path = OUTPUT_COMPARE_CONFIG_PATH;
+    CompareOption option;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            option.thread_num = atoi(argv[++i]);
+        } else if (arg == "--width" && i + 1 < argc) {
+            option.width = atoi(argv[++i]);
+        } else if (arg == "--radix" && i + 1 < argc) {
+            option.radix = (atoi(argv[++i]) == 10) ? 10 : 16;
+        } else if (arg == "--sample-bytes" && i + 1 < argc) {
+            option.sample_bytes = (atoi(argv[++i]) == 1) ? 1 : 2;
+        } else if (arg == "--tile" && i + 1 < argc) {
+            option.tile_size = max(1, atoi(argv[++i]));
+        } else if (arg == "--max-report" && i + 1 < argc) {
+            option.max_report = (size_t)atoi(argv[++i]);
+        } else if (arg == "--no-manifest") {
+            option.manifest_enable = false;
+        } else {
+            config_path = arg;
+        }
+    }
+
     ifstream f(config_path);
     if (!f.is_open()) {
-        MAIN_ERROR_1("Cannot open vibe.json configuration file");
+        MAIN_ERROR_1("Cannot open configuration file: " + config_path);
         return -1;
     }
-    MAIN_INFO_1("vibe.json configuration file path: " + config_path);
-    
+    MAIN_INFO_1("configuration file path: " + config_path);
     json data = json::parse(f);
     f.close();
-    MAIN_INFO_1("vibe.json configuration file parse follow...");
-    
+
     // 检查 output_info 是否存在
     if (!data.contains("output_info")) {
-        MAIN_ERROR_1("output_info not found in vibe.json");
+        MAIN_ERROR_1("output_info not found in " + config_path);
         return -1;
     }
-    
     json output_info = data["output_info"];
-    MAIN_INFO_1("output_info content: " + output_info.dump(2));
-    
-    // 比较结果统计
-    int total_comparisons = 0;
-    int successful_comparisons = 0;
-    
-    // 遍历 output_info 中的所有键值对
-    for (auto& [key, value] : output_info.items()) {
-        // 只处理 alg_ 开头的文件路径
-        if (key.substr(0, 4) == "alg_") {
-            total_comparisons++;
-            
-            // 生成对应的 hls_ 键名
-            string hls_key = "hls" + key.substr(3); // 替换 alg_ 为 hls_
-            
-            // 检查对应的 hls_ 键是否存在
-            if (!output_info.contains(hls_key)) {
-                MAIN_ERROR_1("Corresponding HLS key not found for: " + key);
-                continue;
-            }
-            
-            string alg_file_path = value.get<string>();
-            string hls_file_path = output_info[hls_key].get<string>();
-            
-            MAIN_INFO_1("Comparing files:");
-            MAIN_INFO_1("  Algorithm file: " + alg_file_path);
-            MAIN_INFO_1("  HLS file: " + hls_file_path);
-            
-            // 读取两个文件的内容
-            vector<ALG_OUTPUT_DATA_TYPE> alg_data = vector_read_from_file<ALG_OUTPUT_DATA_TYPE>(alg_file_path);
-            if (alg_data.empty()) {
-                MAIN_ERROR_1("Cannot load algorithm output file: " + alg_file_path);
-                continue;
-            }
-            
-            vector<ALG_OUTPUT_DATA_TYPE> hls_data = vector_read_from_file<ALG_OUTPUT_DATA_TYPE>(hls_file_path);
-            if (hls_data.empty()) {
-                MAIN_ERROR_1("Cannot load HLS output file: " + hls_file_path);
-                continue;
-            }
-            
-            MAIN_INFO_1("  Algorithm data size: " + to_string(alg_data.size()));
-            MAIN_INFO_1("  HLS data size: " + to_string(hls_data.size()));
-            
-            // 调用 vector_compare 进行比较
-            bool comparison_result = vector_compare(alg_data, hls_data);
-            
-            if (comparison_result) {
-                MAIN_INFO_1("  Comparison result: SUCCESS - Files are identical");
-                successful_comparisons++;
-            } else {
-                MAIN_INFO_1("  Comparison result: FAILED - Files are different");
-            }
+
+    // alg_xxx -> hls_xxx pairs
+    vector<string> pair_name;
+    vector<string> alg_path;
+    vector<string> hls_path;
+    for (json::iterator it = output_info.begin(); it != output_info.end(); ++it) {
+        const string& key = it.key();
+        if (key.substr(0, 4) != "alg_") {
+            continue;
+        }
+        string hls_key = "hls" + key.substr(3);
+        if (!output_info.contains(hls_key)) {
+            MAIN_INFO_1("Corresponding HLS key not found for: " + key);
+            continue;
         }
+        string alg_file = it.value().get<string>();
+        string hls_file = output_info[hls_key].get<string>();
+        if (access(alg_file.c_str(), F_OK) != 0 && access(hls_file.c_str(), F_OK) != 0) {
+            MAIN_INFO_1("skip " + alg_file + " vs " + hls_file + ", written by neither model");
+            continue;
+        }
+        pair_name.push_back(key.substr(4));
+        alg_path.push_back(alg_file);
+        hls_path.push_back(hls_file);
+        MAIN_INFO_1("compare " + alg_path.back() + " vs " + hls_path.back());
+    }
+
+    // pairs run concurrently, the worker threads are split among them
+    CompareOption pair_option = option;
+    if (!pair_name.empty()) {
+        pair_option.thread_num = max(1, compare_thread_num(option.thread_num) / (int)pair_name.size());
+    }
+    vector<CompareResult> result(pair_name.size());
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    vector<thread> pair_thread;
+    for (size_t p = 0; p < pair_name.size(); p++) {
+        pair_thread.push_back(thread([&, p]() {
+            result[p] = compare_file(alg_path[p], hls_path[p], pair_option);
+        }));
+    }
+    for (size_t p = 0; p < pair_thread.size(); p++) {
+        pair_thread[p].join();
+    }
+    double second = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    int pass_num = 0;
+    for (size_t p = 0; p < pair_name.size(); p++) {
+        compare_print(OUTPUT_COMPARE_MAIN_SECTION, pair_name[p], result[p], option.max_report);
+        pass_num += result[p].pass() ? 1 : 0;
     }
-    
+
     // 输出比较结果摘要
-    MAIN_INFO_1("\nComparison Summary:");
-    MAIN_INFO_1("Total comparisons: " + to_string(total_comparisons));
-    MAIN_INFO_1("Successful comparisons: " + to_string(successful_comparisons));
-    MAIN_INFO_1("Failed comparisons: " + to_string(total_comparisons - successful_comparisons));
-    
-    if (total_comparisons > 0 && successful_comparisons == total_comparisons) {
-        MAIN_INFO_1("All comparisons passed successfully!");
-    } else if (total_comparisons > 0) {
-        MAIN_INFO_1("Some comparisons failed. Please check the details above.");
-    } else {
+    MAIN_INFO_1("Comparison Summary:");
+    MAIN_INFO_1("Total comparisons: " + to_string(pair_name.size()) + " in " + to_string(second) + " s");
+    MAIN_INFO_1("Successful comparisons: " + to_string(pass_num));
+    MAIN_INFO_1("Failed comparisons: " + to_string(pair_name.size() - pass_num));
+    if (pair_name.empty()) {
         MAIN_INFO_1("No comparison files found in output_info.");
+        return 0;
+    }
+    if (pass_num == (int)pair_name.size()) {
+        MAIN_INFO_1("All comparisons passed successfully!");
+        return 0;
     }
-    
-    return 0;
-}
\ No newline at end of file
+    MAIN_INFO_1("Some comparisons failed. Please check the details above.");
+    return 1;
+}
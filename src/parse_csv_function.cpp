@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <algorithm>
 
 // tool
 #include "parse_csv_function.h"
@@ -13,52 +14,62 @@
 // using
 using namespace std;
 
-// register_info struct implementations
-void RegisterSection::print_values() const {
-    cout << "RegisterSection:" << endl;
-    for (auto reg : reg_map) {
-        if (reg.second.reg_bit_width == 1) {
-            cout << "  " << setw(30) << reg.first << setw(14) << " = " << setw(8) << reg.second.reg_initial_value << endl;
-        } else {
-            cout << "  " << setw(30) << reg.first << "[" << setw(4) << reg.second.reg_bit_width-1 << ":" << setw(4) << "0" << "] = " << setw(8) << reg.second.reg_initial_value << " " << "(range: " << setw(8) << reg.second.reg_value_min << " ~ " << setw(8) << reg.second.reg_value_max << ")" << endl;
-        }
-    }
-}
-
-void LoadCSVFile(RegisterSection &register_section) {
-   string filename = "/home/sheldon/hls_project/vibe_crop/src/register_table.csv";
+RegisterSection LoadCSVFile(const string& filename) {
+   RegisterSection register_section;
    ifstream csv_file(filename);
    if (!csv_file.is_open()) {
-       cerr << "Error: Could not open the file!" << endl;
+       MAIN_ERROR_1("Cannot open register table: " + filename);
    }
    string line;
    vector<string> fields;
+   // columns are found by the header names, extra columns (e.g. reg_address) are ignored
+   const char* column_name[] = {"reg_name", "bitwidth", "initial_value", "cons_min", "cons_max"};
+   size_t column[5];
+   size_t column_max = 0;
    bool first_line = true;
    // Read each line from the CSV file
    while (getline(csv_file, line)) {
-       if (first_line) {
-           first_line = false;
+       line.erase(line.find_last_not_of(" \t\r") + 1);
+       if (line.empty() || line[0] == '#') {
            continue;
        }
        istringstream line_stream(line);
        string field;
        fields.clear();
-    //    MAIN_INFO_1("line: " + line);
        // Split the line into fields using ',' as a delimiter
        while (getline(line_stream, field, ',')) {
+           field.erase(0, field.find_first_not_of(" \t"));
+           field.erase(field.find_last_not_of(" \t") + 1);
            fields.push_back(field);
        }
-    //    RegisterInfo reg_info;
-    //    reg_info.reg_bit_width = stoi(fields[2]);
-    //    reg_info.reg_initial_value = stoi(fields[3]);
-    //    reg_info.reg_value_min = stoi(fields[4]);
-    //    reg_info.reg_value_max = stoi(fields[5]);
-       // Print or process the extracted fields
-       // PrintCSVLine(fields);
-       register_section.reg_map[fields[1]] = stoi(fields[2]);
+       if (first_line) {
+           first_line = false;
+           for (size_t c = 0; c < 5; c++) {
+               vector<string>::const_iterator it = find(fields.begin(), fields.end(), column_name[c]);
+               if (it == fields.end()) {
+                   MAIN_ERROR_1(string("Register table has no column ") + column_name[c] + ": " + filename);
+               }
+               column[c] = it - fields.begin();
+               column_max = max(column_max, column[c]);
+           }
+           continue;
+       }
+       if (fields.size() <= column_max) {
+           MAIN_ERROR_1("Register table line needs " + to_string(column_max + 1) + " fields: " + line);
+       }
+       RegisterInfo reg_info;
+       reg_info.reg_bit_width = stoi(fields[column[1]], nullptr, 0);
+       istringstream value_stream(fields[column[2]]);
+       string value;
+       while (value_stream >> value) {
+           reg_info.reg_initial_value.push_back(stoi(value, nullptr, 0));
+       }
+       reg_info.reg_value_min = stoi(fields[column[3]], nullptr, 0);
+       reg_info.reg_value_max = stoi(fields[column[4]], nullptr, 0);
+       register_section.reg_map[fields[column[0]]] = reg_info;
    }
-   register_section.print_values();
    csv_file.close();
+   return register_section;
 }
 
 
@@ -75,8 +86,7 @@ void PrintCSVLine(const vector<string>& line_data) {
    cout << endl;
 }
 
-void PrintCSVFile() {
-   string filename = "/home/sheldon/hls_project/vibe_crop/src/register_table.csv";
+void PrintCSVFile(const string& filename) {
    ifstream csv_file(filename);
    if (!csv_file.is_open()) {
        cerr << "Error: Could not open the file!" << endl;
@@ -99,9 +109,12 @@ void PrintCSVFile() {
    csv_file.close();
 }
 
-int main() {
-    // PrintCSVFile();
-    RegisterSection rs;
-    LoadCSVFile(rs);
+#ifdef PARSE_CSV_FUNCTION_MAIN
+int main(const int argc, const char *argv[]) {
+    string filename = (argc > 1) ? argv[1] : "/home/sheldon/hls_project/vibe_crop/src/register_table.csv";
+    PrintCSVFile(filename);
+    RegisterSection register_section = LoadCSVFile(filename);
+    register_section.print_values();
     return 0;
 }
+#endif
@@ -1,3 +1,6 @@
+#ifndef PARSE_CSV_FUNCTION_H
+#define PARSE_CSV_FUNCTION_H
+
 // std
 #include <iostream>
 #include <fstream>
@@ -8,20 +11,21 @@
 
 // tool
 #include "print_function.h"
-#include "vector_function.h"
+#include "parse_json_function.h"
 
 // using
 using namespace std;
 
 
-// register_info struct
-struct RegisterSection {
-    map<string, int> reg_map;
-    
-    void print_values() const;
-};
+// register table as written by py/convert_json_to_csv.py: a header line, then one register per line
+// reg_name,bitwidth,initial_value,cons_min,cons_max (multiple initial values separated by spaces)
+// columns are looked up by header name, so tables with extra columns (config/register_table.csv has
+// reg_address first) load the same way
+// the result is the same RegisterSection as register_info of the json config
 
 // csv parser function
 extern void PrintCSVLine(const vector<string>& line_data);
-extern void PrintCSVFile();
+extern void PrintCSVFile(const string& filename);
 extern RegisterSection LoadCSVFile(const string& filename);
+
+#endif // PARSE_CSV_FUNCTION_H
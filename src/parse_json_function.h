@@ -5,6 +5,9 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <vector>
+#include <map>
 
 // tool
 #include "json.hpp"
@@ -48,7 +51,6 @@ struct OutputSection {
     }
 };
 
-/*
 struct RegisterInfo {
     int reg_bit_width;
     vector<int> reg_initial_value;
@@ -62,94 +64,96 @@ struct RegisterSection {
     void print_values() const {
         cout << "RegisterSection:" << endl;
         for (auto reg : reg_map) {
-            if (reg.second.reg_bit_width == 1) {
+            if (reg.second.reg_initial_value.empty()) {
+                cout << "  " << setw(30) << reg.first << " = (no value)" << endl;
+            } else if (reg.second.reg_bit_width == 1) {
                 cout << "  " << setw(30) << reg.first << setw(14) << " = " << setw(8) << reg.second.reg_initial_value[0] << endl;
-            } else {
-                if (reg.second.reg_initial_value.size() > 1) {
-                    cout << "  " << setw(30) << reg.first << "[" << setw(4) <<reg.second.reg_bit_width-1 << ":" << "0] = [";
-                    for (int i=0; i<reg.second.reg_initial_value.size(); i++) {
-                        cout << reg.second.reg_initial_value[i] << " ";
-                    }
-                    cout << "] " << "(range: " << setw(8) << reg.second.reg_value_min << " ~ " << setw(8) << reg.second.reg_value_max << ")" << endl;
-                } else {
-                    cout << "  " << setw(30) << reg.first << "[" << setw(4) << reg.second.reg_bit_width-1 << ":" << setw(4) << "0" << "] = " << setw(8) << reg.second.reg_initial_value[0] << " " << "(range: " << setw(8) << reg.second.reg_value_min << " ~ " << setw(8) << reg.second.reg_value_max << ")" << endl;
+            } else if (reg.second.reg_initial_value.size() > 1) {
+                cout << "  " << setw(30) << reg.first << "[" << setw(4) << reg.second.reg_bit_width-1 << ":" << "0] = [";
+                for (size_t i = 0; i < reg.second.reg_initial_value.size(); i++) {
+                    cout << reg.second.reg_initial_value[i] << " ";
                 }
+                cout << "] " << "(range: " << setw(8) << reg.second.reg_value_min << " ~ " << setw(8) << reg.second.reg_value_max << ")" << endl;
+            } else {
+                cout << "  " << setw(30) << reg.first << "[" << setw(4) << reg.second.reg_bit_width-1 << ":" << setw(4) << "0" << "] = " << setw(8) << reg.second.reg_initial_value[0] << " " << "(range: " << setw(8) << reg.second.reg_value_min << " ~ " << setw(8) << reg.second.reg_value_max << ")" << endl;
             }
         }
     }
 
-    // void randomize_check() const {
-    //     for (auto reg : reg_map) {
-    //         if (reg.second.reg_bit_width == 1) {
-    //             if (reg.second.reg_initial_value[0] != 0 && reg.second.reg_initial_value[0] != 1) {
-    //                 cout << "Error: " << reg.first << " initial value must be 0 or 1" << endl;
-    //             }
-    //         } else {
-    //             if (reg.second.reg_initial_value.size() != reg.second.reg_bit_width) {
-    //                 cout << "Error: " << reg.first << " initial value size must be " << reg.second.reg_bit_width << endl;
-    //             }
-    //         }
-    //     }
-    // }
-
+    // initial value of reg_name, exits when the register is missing from the config
+    int value(const string& reg_name, size_t index = 0) const {
+        map<string, RegisterInfo>::const_iterator it = reg_map.find(reg_name);
+        if (it == reg_map.end() || it->second.reg_initial_value.size() <= index) {
+            MAIN_ERROR_1("Register not found in register_info: " + reg_name);
+        }
+        return it->second.reg_initial_value[index];
+    }
 };
 
+    
+// register_info loading
+inline void from_json(const json& j, RegisterInfo& reg) {
+    reg.reg_bit_width = j["reg_bit_width"];
+    reg.reg_value_min = j["reg_value_min"];
+    reg.reg_value_max = j["reg_value_max"];
+    reg.reg_initial_value = j["reg_initial_value"].get<std::vector<int>>();
+}
 
 inline void from_json(const json& j, RegisterSection& info) {
     for (auto& reg : j.items()) {
         from_json(reg.value(), info.reg_map[reg.key()]);
     }
-    // from_json(j["reg_image_width"], info.reg_image_width);
-    // from_json(j["reg_image_height"], info.reg_image_height);
-    // from_json(j["reg_smooth_filter_enable"], info.reg_smooth_filter_enable);
-    // from_json(j["reg_smooth_filter_coeff"], info.reg_smooth_filter_coeff);
-    // from_json(j["reg_dpc_enable"], info.reg_dpc_enable);
-    // from_json(j["reg_dpc_threshold"], info.reg_dpc_threshold);
-    // from_json(j["reg_crop_enable"], info.reg_crop_enable);
-    // from_json(j["reg_crop_start_x"], info.reg_crop_start_x);
-    // from_json(j["reg_crop_start_y"], info.reg_crop_start_y);
-    // from_json(j["reg_crop_end_x"], info.reg_crop_end_x);
-    // from_json(j["reg_crop_end_y"], info.reg_crop_end_y);
 }
-        
 
-        #define RANDOM_REG_ENABLE
-inline void from_json(const json& j, RegisterInfo& reg) {
-    reg.reg_bit_width = j["reg_bit_width"];
-    reg.reg_value_min = j["reg_value_min"];
-    reg.reg_value_max = j["reg_value_max"];
-    
-    #ifdef RANDOM_REG_ENABLE
-    // randomize register section
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(reg.reg_value_min, reg.reg_value_max);
-    reg.reg_initial_value = j["reg_initial_value"].get<std::vector<int>>();
-    for (int i=0; i<reg.reg_initial_value.size(); i++) {
-            reg.reg_initial_value[i] = dis(gen);
-        }
-        #else
-        reg.reg_initial_value = j["reg_initial_value"].get<std::vector<int>>();
-        #endif
+// vibe.json field names follow ImageSection / OutputSection. Configs written before the rename still load,
+// the old key is read with a warning:
+//   image_info.image_format           -> image_info.src_image_format
+//   image_info.image_data_bitwidth    -> image_info.src_image_data_bitwidth
+//   image_info.generate_random_image  -> image_info.generate_random_src_image_enable
+//   image_info.image_path             -> output_info.src_image_path
+//   image_info.random_image_path      -> output_info.random_src_image_path
+// output_info.py_dpc_output_path is new and optional (only the python flow writes it)
+inline const json& json_field(const json& j, const string& name, const string& old_name = "") {
+    if (j.contains(name)) {
+        return j.at(name);
     }
-*/
-    
+    if (!old_name.empty() && j.contains(old_name)) {
+        MAIN_INFO_1("config key " + old_name + " is deprecated, rename it to " + name);
+        return j.at(old_name);
+    }
+    MAIN_ERROR_1("config key missing: " + name);
+    return j;
+}
+
 // image_info loading
 inline void from_json(const json& j, ImageSection& info) {
-    info.src_image_format = j["src_image_format"];
-    info.src_image_data_bitwidth = j["src_image_data_bitwidth"];
-    info.generate_random_src_image_enable = j["generate_random_src_image_enable"];
+    info.src_image_format = json_field(j, "src_image_format", "image_format").get<string>();
+    info.src_image_data_bitwidth = json_field(j, "src_image_data_bitwidth", "image_data_bitwidth").get<int>();
+    info.generate_random_src_image_enable = json_field(j, "generate_random_src_image_enable", "generate_random_image").get<int>();
+}
+
+// output_info loading, image_info holds the image paths in configs written before the rename
+inline void from_json_output_section(const json& j, const json& image_info, OutputSection& info) {
+    const json& src_image = j.contains("src_image_path") ? j : image_info;
+    const json& random_src_image = j.contains("random_src_image_path") ? j : image_info;
+    info.src_image_path = json_field(src_image, "src_image_path", "image_path").get<string>();
+    info.random_src_image_path = json_field(random_src_image, "random_src_image_path", "random_image_path").get<string>();
+    info.alg_crop_output_path = json_field(j, "alg_crop_output_path").get<string>();
+    info.alg_dpc_output_path = json_field(j, "alg_dpc_output_path").get<string>();
+    info.py_dpc_output_path = j.value("py_dpc_output_path", string());
+    info.hls_crop_output_path = json_field(j, "hls_crop_output_path").get<string>();
+    info.hls_dpc_output_path = json_field(j, "hls_dpc_output_path").get<string>();
 }
 
-// output_info loading
 inline void from_json(const json& j, OutputSection& info) {
-    info.src_image_path = j["src_image_path"];
-    info.random_src_image_path = j["random_src_image_path"];
-    info.alg_crop_output_path = j["alg_crop_output_path"];
-    info.alg_dpc_output_path = j["alg_dpc_output_path"];
-    info.py_dpc_output_path = j["py_dpc_output_path"];
-    info.hls_crop_output_path = j["hls_crop_output_path"];
-    info.hls_dpc_output_path = j["hls_dpc_output_path"];
+    from_json_output_section(j, json::object(), info);
+}
+
+// output_info of a whole image_config.json
+inline OutputSection GetOutputSection(const json& data) {
+    OutputSection output_section;
+    from_json_output_section(json_field(data, "output_info"), data.contains("image_info") ? data.at("image_info") : json::object(), output_section);
+    return output_section;
 }
 
 inline ImageSection LoadImageConfigJsonImageSection(const string& filename) {
@@ -170,8 +174,7 @@ inline OutputSection LoadImageConfigJsonOutputSection(const string& filename) {
     }
     json data = json::parse(f);
     f.close();
-    OutputSection output_section = data["output_info"].get<OutputSection>();
-    return output_section;
+    return GetOutputSection(data);
 }
 
 
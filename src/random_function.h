@@ -0,0 +1,133 @@
+#ifndef RANDOM_FUNCTION_H
+#define RANDOM_FUNCTION_H
+
+// small deterministic random generators for randomized campaigns
+//  - splitmix64(x): stateless 64 bit mix, derives an independent seed per case / tile from
+//    (campaign seed, index), so a case reproduces alone and independently of thread scheduling
+//  - Xoshiro256ss: xoshiro256** generator, 32 bytes of state, seeded through splitmix64, far cheaper
+//    to create per case than mt19937 (2.5 KB state) and usable with the std distributions
+//    (UniformRandomBitGenerator)
+//  - Xoshiro256ssLanes<N>: N independent xoshiro256** streams with the state stored per word across
+//    the lanes, one next() steps all lanes in one loop the compiler vectorizes (bulk fills)
+
+// std
+#include <cstdint>
+#include <limits>
+
+// def
+#define RANDOM_FUNCTION_SECTION "[random_function]"
+
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+// seed of item index in the campaign seeded with seed
+inline uint64_t random_seed(uint64_t seed, uint64_t index) {
+    return splitmix64(splitmix64(seed) ^ splitmix64(index + 0x632be59bd9b4e019ULL));
+}
+
+
+class Xoshiro256ss {
+public:
+    typedef uint64_t result_type;
+
+    explicit Xoshiro256ss(uint64_t seed = 1) {
+        this->seed(seed);
+    }
+
+    void seed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            seed += 0x9e3779b97f4a7c15ULL;
+            state[i] = splitmix64(seed);
+        }
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    // uniform in [lo, hi], multiply-shift on the high 32 bits, bias below 2^-32 for ranges up to 2^32
+    int64_t uniform(int64_t lo, int64_t hi) {
+        uint64_t range = (uint64_t)(hi - lo) + 1;
+        if (range == 0) {
+            return (int64_t)(*this)();
+        }
+        if (range <= 0xffffffffULL) {
+            return lo + (int64_t)((((*this)() >> 32) * range) >> 32);
+        }
+        return lo + (int64_t)((*this)() % range);
+    }
+
+    bool bernoulli(double p) {
+        return ((*this)() >> 11) * (1.0 / 9007199254740992.0) < p;
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4];
+};
+
+
+template <int N>
+class Xoshiro256ssLanes {
+public:
+    enum { LANES = N };
+
+    explicit Xoshiro256ssLanes(uint64_t seed = 1) {
+        this->seed(seed);
+    }
+
+    // lane i starts as Xoshiro256ss(random_seed(seed, i))
+    void seed(uint64_t seed) {
+        for (int i = 0; i < N; i++) {
+            uint64_t lane_seed = random_seed(seed, (uint64_t)i);
+            for (int k = 0; k < 4; k++) {
+                lane_seed += 0x9e3779b97f4a7c15ULL;
+                state[k][i] = splitmix64(lane_seed);
+            }
+        }
+    }
+
+    // one output per lane into result[0 .. N)
+    void next(uint64_t* result) {
+        for (int i = 0; i < N; i++) {
+            uint64_t s1 = state[1][i];
+            result[i] = rotl(s1 * 5, 7) * 9;
+            uint64_t t = s1 << 17;
+            state[2][i] ^= state[0][i];
+            state[3][i] ^= s1;
+            state[1][i] = s1 ^ state[2][i];
+            state[0][i] ^= state[3][i];
+            state[2][i] ^= t;
+            state[3][i] = rotl(state[3][i], 45);
+        }
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t state[4][N];
+};
+
+
+#endif // RANDOM_FUNCTION_H
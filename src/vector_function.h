@@ -8,9 +8,13 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
 
 // tool
 #include "print_function.h"
+#include "hash_function.h"
 
 // ip
 #include "hls_info.h"
@@ -19,18 +23,89 @@
 // def
 #define VECTOR_FUNCTION_SECTION "[vector_function]"
 
+#define VECTOR_RAW_CHUNK_SAMPLES (1 << 16)
+
 // using
 using namespace std;
 
 
-template <typename T>
-vector<T> vector_read_from_file(const string& filename) {
+// binary frame format: .raw / .bin, 16-bit little endian samples in raster order, no header
+inline bool vector_is_raw_path(const string& filename) {
+    size_t dot_pos = filename.find_last_of('.');
+    if (dot_pos == string::npos) {
+        return false;
+    }
+    string ext = filename.substr(dot_pos + 1);
+    for (size_t i = 0; i < ext.size(); i++) {
+        ext[i] = (char)tolower((unsigned char)ext[i]);
+    }
+    return ext == "raw" || ext == "bin";
+}
+
+// vector_try_read_*: false when the file cannot be opened, for callers that must not exit (worker threads)
+template <typename T, typename ALLOC>
+bool vector_try_read_from_raw_file(const string& filename, vector<T, ALLOC>& data) {
+    data.clear();
+    FILE* input_file = fopen(filename.c_str(), "rb");
+    if (!input_file) {
+        return false;
+    }
+    if (fseek(input_file, 0, SEEK_END) == 0) {
+        long file_size = ftell(input_file);
+        data.reserve(file_size > 0 ? (size_t)file_size / 2 : 0);
+        fseek(input_file, 0, SEEK_SET);
+    }
+    vector<uint8_t> chunk(2 * VECTOR_RAW_CHUNK_SAMPLES);
+    size_t byte_num;
+    while ((byte_num = fread(chunk.data(), 1, chunk.size(), input_file)) >= 2) {
+        for (size_t i = 0; i + 1 < byte_num; i += 2) {
+            data.push_back(static_cast<T>(chunk[i] | (chunk[i + 1] << 8)));
+        }
+    }
+    fclose(input_file);
+    return true;
+}
+
+template <typename T, typename ALLOC>
+bool vector_write_to_raw_file(const string& filename, const vector<T, ALLOC>& data) {
+    FILE* output_file = fopen(filename.c_str(), "wb");
+    if (!output_file) {
+        std::cerr << "Cannot open output file: " << filename << std::endl;
+        return false;
+    }
+    vector<uint8_t> chunk(2 * VECTOR_RAW_CHUNK_SAMPLES);
+    bool ok = true;
+    for (size_t i0 = 0; i0 < data.size() && ok; i0 += VECTOR_RAW_CHUNK_SAMPLES) {
+        size_t n = min<size_t>(VECTOR_RAW_CHUNK_SAMPLES, data.size() - i0);
+        for (size_t i = 0; i < n; i++) {
+            uint16_t v = static_cast<uint16_t>(data[i0 + i]);
+            chunk[2 * i] = (uint8_t)v;
+            chunk[2 * i + 1] = (uint8_t)(v >> 8);
+        }
+        ok = fwrite(chunk.data(), 1, 2 * n, output_file) == 2 * n;
+    }
+    return fclose(output_file) == 0 && ok;
+}
+
+template <typename T, typename ALLOC>
+bool vector_read_from_raw_file(const string& filename, vector<T, ALLOC>& data) {
+    if (!vector_try_read_from_raw_file(filename, data)) {
+        MAIN_ERROR_1("Cannot open input file: " + filename);
+        return false;
+    }
+    return true;
+}
+
+template <typename T, typename ALLOC>
+bool vector_try_read_from_file(const string& filename, vector<T, ALLOC>& data) {
+    if (vector_is_raw_path(filename)) {
+        return vector_try_read_from_raw_file(filename, data);
+    }
     ifstream input_file(filename);
-    vector<T> data;
+    data.clear();
     
     if (!input_file) {
-        MAIN_ERROR_1("Cannot open input file: " + filename);
-        return data;
+        return false;
     }
     
     string line;
@@ -55,16 +130,27 @@ vector<T> vector_read_from_file(const string& filename) {
     }
     
     input_file.close();
-    return data;
+    return true;
 }
 
-template <typename T>
-bool vector_write_to_file(const std::string& filename, const std::vector<T>& data) {
-    return vector_write_to_file(filename, data, 0, 0);
+template <typename T, typename ALLOC>
+bool vector_read_from_file(const string& filename, vector<T, ALLOC>& data) {
+    if (!vector_try_read_from_file(filename, data)) {
+        MAIN_ERROR_1("Cannot open input file: " + filename);
+        return false;
+    }
+    return true;
 }
 
 template <typename T>
-bool vector_write_to_file(const std::string& filename, const std::vector<T>& data, int width, int height) {
+vector<T> vector_read_from_file(const string& filename) {
+    vector<T> data;
+    vector_read_from_file(filename, data);
+    return data;
+}
+
+template <typename T, typename ALLOC>
+bool vector_write_to_file(const std::string& filename, const std::vector<T, ALLOC>& data, int width, int height) {
     ofstream output_file(filename);
     if (!output_file) {
         std::cerr << "Cannot open output file: " << filename << std::endl;
@@ -82,25 +168,82 @@ bool vector_write_to_file(const std::string& filename, const std::vector<T>& dat
     return true;
 }
 
-template <typename T, typename U>
-void vector_to_stream(const vector<T>& rdata, hls::stream<U>& wdata) {
+template <typename T, typename ALLOC>
+bool vector_write_to_file(const std::string& filename, const std::vector<T, ALLOC>& data) {
+    return vector_write_to_file(filename, data, 0, 0);
+}
+
+// what vector_to_stream does with a sample outside the W-bit range of the stream
+enum StreamOverflowPolicy {
+    STREAM_OVERFLOW_CLAMP,      // saturate to [0, 2^W - 1]
+    STREAM_OVERFLOW_MASK,       // keep the low W bits, like an ap_uint<W> assignment
+    STREAM_OVERFLOW_ERROR       // stop on the first bad sample
+};
+
+// ap_axiu<D, 0, ...> has no (or a zero-width) user field, only touch it when U > 0
+template <bool HAS_USER>
+struct axis_user_setter {
+    template <typename P>
+    static void set(P& data_pkt, bool value) { data_pkt.user = value; }
+};
+
+template <>
+struct axis_user_setter<false> {
+    template <typename P>
+    static void set(P&, bool) {}
+};
+
+template <int D, int U, int TI, int TD>
+inline void axis_set_sof(ap_axiu<D, U, TI, TD>& data_pkt, bool sof) {
+    axis_user_setter<(U > 0)>::set(data_pkt, sof);
+}
+
+// one frame into an AXI4-Stream, the sample width comes from the stream type
+//  - keep/strb all ones, user = start of frame on the first beat
+//  - last = end of line every line_pixels samples (the kernels' framing), on the final beat only if 0
+//  - out of range samples are handled by policy and reported once, returns how many there were
+template <typename T, typename ALLOC, int D, int U, int TI, int TD>
+size_t vector_to_stream(const vector<T, ALLOC>& rdata, hls_stream_t<ap_axiu<D, U, TI, TD>>& wdata,
+                        StreamOverflowPolicy policy = STREAM_OVERFLOW_CLAMP, size_t line_pixels = 0) {
+    const int64_t max_value = (D >= 63) ? INT64_MAX : ((int64_t(1) << D) - 1);
+    size_t overflow_count = 0;
+    hls_stream_reserve(wdata, rdata.size());
+
+    ap_axiu<D, U, TI, TD> data_pkt;
+    data_pkt.keep = -1;
+    data_pkt.strb = -1;
     for (size_t i = 0; i < rdata.size(); ++i) {
-        U data_pkt;
-        if (rdata[i] >= 256) {
-            std::cerr << "Warning: Value " << rdata[i] << " exceeds 8-bit range, truncating" << std::endl;
-            data_pkt.data = 255; // 8-bit max
-        } else {
-            data_pkt.data = rdata[i];
+        int64_t value = static_cast<int64_t>(rdata[i]);
+        if (value < 0 || value > max_value) {
+            if (policy == STREAM_OVERFLOW_ERROR) {
+                MAIN_ERROR_1("Value " + to_string(value) + " at index " + to_string(i) + " exceeds " + to_string(D) + "-bit range");
+            }
+            overflow_count++;
+            if (policy == STREAM_OVERFLOW_CLAMP) {
+                value = (value < 0) ? 0 : max_value;
+            } else {
+                value &= max_value;
+            }
         }
-        data_pkt.last = (i == rdata.size() - 1) ? 1 : 0;
+        data_pkt.data = value;
+        axis_set_sof(data_pkt, i == 0);
+        data_pkt.last = (line_pixels > 0 ? (i + 1) % line_pixels == 0 : i == rdata.size() - 1) ? 1 : 0;
         wdata.write(data_pkt);
     }
+
+    if (overflow_count > 0) {
+        MAIN_INFO_1("Warning: " + to_string(overflow_count) + " of " + to_string(rdata.size()) + " values exceed "
+                    + to_string(D) + "-bit range, " + (policy == STREAM_OVERFLOW_CLAMP ? "clamped" : "masked"));
+    }
+    return overflow_count;
 }
 
-template <typename T, typename U>
-void stream_to_vector(hls::stream<U>& rdata, vector<T>& wdata) {
+// drains the stream into wdata, frame_size (if known) sizes the output once
+template <typename T, typename ALLOC, int D, int U, int TI, int TD>
+void stream_to_vector(hls_stream_t<ap_axiu<D, U, TI, TD>>& rdata, vector<T, ALLOC>& wdata, size_t frame_size = 0) {
+    wdata.reserve(wdata.size() + (frame_size > 0 ? frame_size : (size_t)rdata.size()));
     while (!rdata.empty()) {
-        auto data_pkt = rdata.read();
+        ap_axiu<D, U, TI, TD> data_pkt = rdata.read();
         wdata.push_back(static_cast<T>(data_pkt.data));
     }
 }